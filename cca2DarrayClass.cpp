@@ -1,6 +1,5 @@
 /*
-IF USING STACK MEMORY FOR THE APP THEN INCREASE STACK RESERVE SIZE TO ABOUT 3 MB
-MSVC: Project > Properties > Linker > Configuration Properties > Linker > System > Stack Reserve Size: 3145728
+THE GRIDS ARE ALLOCATED ON THE HEAP WHATEVER THEIR SIZE, SO THE APP RUNS FROM THE STACK WITHOUT A BIGGER STACK RESERVE
 
 By default, the main application will use the heap memory. That can be changed in the main function.
 */
@@ -8,100 +7,878 @@ By default, the main application will use the heap memory. That can be changed i
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 #include <stdlib.h>
+#include <type_traits>
+#include <bitset>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <new>
+#include <random>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CCA_X86
+#include <immintrin.h>
+#if defined(__GNUC__)
+#include <cpuid.h>
+#endif
+#endif
 
 // MODIFY THESE CONSTANTS TO CHANGE THE ACTIVE RULE ///////
 #define RANGE 6
 #define THRESHOLD 7
 #define COLORS 18
-#define NH false    // true for Moore, false for vonNeumann
+#define NH VON_NEUMANN   // MOORE, VON_NEUMANN, CIRCULAR, CROSS or HEXAGONAL (true/false still mean Moore/vonNeumann)
 ///////////////////////////////////////////////////////////
 
-#define TOT_SIZE 580
-#define INNER_SIZE 540
+#define ENGINE AUTO     // stepping engine used for every generation, see the Engine enum below
+
+#define BYTE_CELLS true // store the states as int8_t instead of int, so the grid fits in L2
+
+#define THREADS 0       // threads stepping each generation, 0 means one per hardware thread
+#define TILE_SIZE 60    // side of the square tiles the threads take turns on, a divisor of the grid size keeps them all full
+
+#define GRID_WIDTH 540  // simulated cells along x and y, the window shows INNER_SIZE x INNER_SIZE of them
+#define GRID_HEIGHT 540
+#define BOUNDARY CLAMPED    // what lies past the edges of the grid, see the Boundary enum below
+#define HUGE_PAGES false    // ask for transparent huge pages for the grids (Linux), worth it for the big ones
+#define BENCHMARK false // print the time to draw the window at a few grid sizes instead of opening it
+#define HEADLESS 0      // run this many generations without a window or OpenGL context and print their speed, 0 opens the window
+
+#define TOT_SIZE 580    // size of the window
+#define INNER_SIZE 540  // size of the part of the window that shows the grid
 #define MARGIN 15
 #define BORDER 5
 
+enum Engine {
+    AUTO,           // SIMD when the CPU and BYTE_CELLS allow it, PACKED for int cells and up to 16 states, else BITPLANE for threshold 1, EARLY_EXIT for range 1 and custom shapes, otherwise SLIDING_WINDOW for Moore and DIAMOND for vonNeumann
+    EARLY_EXIT,     // scans each cell's neighbourhood and stops as soon as the threshold is reached
+    SLIDING_WINDOW, // keeps running per-state counts while sliding along each column (Moore only)
+    DIAMOND,        // counts each diamond from rotated prefix sums (vonNeumann only)
+    SPECIALISED,    // kernel compiled for the exact range, threshold and neighbourhood (rules of the table in SetupEngine only)
+    BITPLANE,       // one bit per cell and state, counted with popcount, 64 cells per word at threshold 1 (range up to 31)
+    SIMD,           // 16, 32 or 64 cells per instruction with SSE2, AVX2 or AVX-512, picked with CPUID (BYTE_CELLS, threshold up to 255)
+    PACKED          // SIMD on the grid kept two cells per byte, half the memory of byte cells and twice the cells per load (up to 16 states, 15 with clamped edges)
+};
+
+enum Boundary {
+    CLAMPED,        // the cells past the edges hold no state, so they never count as a neighbour (the original behaviour)
+    TOROIDAL,       // the grid wraps around, the left edge meets the right one and the top meets the bottom
+    MIRROR          // the grid is reflected at its edges, the k-th cell past an edge copies the k-th cell inside it
+};
+
+enum Shape {
+    VON_NEUMANN,    // |i| + |j| <= range
+    MOORE,          // the whole (2 * range + 1) square
+    CIRCULAR,       // i * i + j * j <= range * range
+    CROSS,          // the row and the column through the cell
+    HEXAGONAL       // hex distance in axial coordinates: the square without two opposite corners
+};
+
+// Signed in both modes, the SIMD kernels and the diamond tables use negative values as markers
+typedef std::conditional<BYTE_CELLS, int8_t, int>::type Cell;
+
 struct Color {
 	int red;
 	int green;
 	int blue;
 };
 
-class DoubleArray {
+// Read-only window onto one generation held by a CellGrid, for the engines and anything that inspects
+// or exports the grid without copying it. Cell (x, y) is data[x * stride + y]. A view points at the grid
+// itself, so it sees every generation as soon as its changes are applied.
+struct GridView {
+    const Cell* data;
+    int width;
+    int height;
+    int stride;
+
+    Cell at(int x, int y) const {
+        return *cell(x, y);
+    }
+
+    const Cell* cell(int x, int y) const {
+        return data + (size_t)x * stride + y;
+    }
+
+    const Cell* column(int x) const {
+        return cell(x, 0);
+    }
+};
+
+// The same for a PackedGrid. Row y of a column is nibble first + y of it, counted from the low nibble of
+// its first byte, so a view can start at a row of either parity.
+struct PackedView {
+    const uint8_t* data;
+    int width;
+    int height;
+    int stride;     // bytes between two columns
+    int first;      // nibble holding row 0
+
+    Cell at(int x, int y) const {
+        return (Cell)((*pairs(x, y) >> shift(y)) & 0x0F);
+    }
+
+    const uint8_t* pairs(int x, int y) const {  // the byte holding (x, y)
+        return data + (size_t)x * stride + ((first + y) >> 1);
+    }
+
+    int shift(int y) const {    // of row y within its byte
+        return ((first + y) & 1) << 2;
+    }
+};
+
+// What LatestGeneration hands out: the engines keep the grid either as whole cells or, for PACKED, as nibbles,
+// and at() reads a state from whichever holds it
+struct GenerationView {
+    GridView cells;     // data is null when the grid is packed
+    PackedView packed;  // data is null otherwise
+    int width;
+    int height;
+
+    Cell at(int x, int y) const {
+        return cells.data ? cells.at(x, y) : packed.at(x, y);
+    }
+};
+
+// One aligned heap block, released as a whole. With huge pages it is aligned to 2 MB and marked
+// so that Linux can back it with transparent huge pages. The memory is left untouched: whoever
+// writes it first decides where the pages end up, see CCA::AllocateGrid.
+class Arena {
+private:
+    void* m_base = nullptr;
+    size_t m_size = 0;
+public:
+    ~Arena() {
+        release();
+    }
+
+    void* allocate(size_t bytes, bool hugePages) {
+        release();
+        size_t alignment = hugePages ? (size_t(2) << 20) : 64;
+        m_size = (bytes + alignment - 1) / alignment * alignment;
+#if defined(_WIN32)
+        m_base = _aligned_malloc(m_size, alignment);
+#else
+        if (posix_memalign(&m_base, alignment, m_size) != 0) m_base = nullptr;    // std::aligned_alloc needs C++17
+#endif
+        if (!m_base) throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (hugePages) madvise(m_base, m_size, MADV_HUGEPAGE);
+#endif
+        return m_base;
+    }
+
+    void release() {
+#if defined(_WIN32)
+        _aligned_free(m_base);
+#else
+        std::free(m_base);
+#endif
+        m_base = nullptr;
+        m_size = 0;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+};
+
+// The grid, columns x rows cells, with cell (x, y) at x * stride() + y. It holds a single generation: the engines
+// only read it and list the cells that transition, and the lists are written back once every cell has been
+// evaluated (see CCA::OnUserUpdate), so no second array is needed to keep the generations apart.
+class CellGrid {
+private:
+    Arena m_arena;
+    Cell* m_cells = nullptr;
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_stride = 0;       // distance between (x, y) and (x + 1, y), rows rounded up to whole cache lines
+public:
+    // Sizes the array without touching it, fill_columns does the first writes
+    void allocate(int columns, int rows, bool hugePages) {
+        const int lineCells = 64 / sizeof(Cell);
+        m_columns = columns;
+        m_rows = rows;
+        m_stride = (rows + lineCells - 1) / lineCells * lineCells;
+        size_t cells = (size_t)columns * m_stride + lineCells;     // a line of slack, vector loads may run past the last column
+        m_cells = (Cell*)m_arena.allocate(cells * sizeof(Cell), hugePages);
+    }
+
+    void fill_columns(int first, int last, Cell value) {
+        std::fill(m_cells + (size_t)first * m_stride, m_cells + (size_t)last * m_stride, value);
+    }
+
+    int stride() const {
+        return m_stride;
+    }
+
+    void copy_column(int from, int to) {
+        std::copy(m_cells + (size_t)from * m_stride, m_cells + (size_t)(from + 1) * m_stride, m_cells + (size_t)to * m_stride);
+    }
+
+    void copy_cell(int fromX, int fromY, int toX, int toY) {
+        m_cells[(size_t)toX * m_stride + toY] = m_cells[(size_t)fromX * m_stride + fromY];
+    }
+
+    void set(int x, int y, int value) {
+        m_cells[(size_t)x * m_stride + y] = value;
+    }
+
+    Cell* column(int x) {  // cell (x, y) is column(x)[y]
+        return m_cells + (size_t)x * m_stride;
+    }
+
+    GridView view() const {
+        return { m_cells, m_columns, m_rows, m_stride };
+    }
+};
+
+// The same grid two cells per byte, the one PACKED keeps instead of a CellGrid. Row y of a column is nibble
+// y + lead of it, the low nibble of a byte for even ones. The lead is 2 or 3 rows, so the reads of the kernels
+// stay inside the column and firstRow lands in a low nibble: with an even tile size every tile then owns whole
+// bytes, and tiles can be written from several threads at once.
+class PackedGrid {
 private:
-    std::array<std::array<int, TOT_SIZE>, TOT_SIZE> m_first = {};
-    std::array<std::array<int, TOT_SIZE>, TOT_SIZE> m_second = {};
-    bool m_first_curr = true;
+    Arena m_arena;
+    uint8_t* m_bytes = nullptr;
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_stride = 0;       // bytes between two columns, rounded up to whole cache lines
+    int m_lead = 0;
 public:
-    void copy() {
-        for (int i = 0; i < TOT_SIZE; i++)
-            for (int j = 0; j < TOT_SIZE; j++)
-                m_second[i][j] = m_first[i][j];
+    // Sizes the array without touching it, fill_columns does the first writes. reach is how many bytes
+    // the kernels may read past the rows of the last column.
+    void allocate(int columns, int rows, int firstRow, int reach, bool hugePages) {
+        m_columns = columns;
+        m_rows = rows;
+        m_lead = 2 + (firstRow & 1);
+        m_stride = ((rows + m_lead + 1) / 2 + 63) / 64 * 64;
+        m_bytes = (uint8_t*)m_arena.allocate((size_t)columns * m_stride + 64 + reach, hugePages);
+    }
+
+    void fill_columns(int first, int last, int value) {    // value is cut to a nibble
+        std::fill(m_bytes + (size_t)first * m_stride, m_bytes + (size_t)last * m_stride, (uint8_t)((value & 0x0F) * 0x11));
+    }
+
+    int stride() const {
+        return m_stride;
+    }
+
+    void copy_column(int from, int to) {
+        std::copy(m_bytes + (size_t)from * m_stride, m_bytes + (size_t)(from + 1) * m_stride, m_bytes + (size_t)to * m_stride);
+    }
+
+    void copy_cell(int fromX, int fromY, int toX, int toY) {
+        set(toX, toY, view().at(fromX, fromY));
+    }
+
+    void set(int x, int y, int value) {
+        uint8_t* pair = pairs(x, y);
+        const int shift = ((y + m_lead) & 1) << 2;
+        *pair = (uint8_t)((*pair & ~(0x0F << shift)) | (value << shift));
+    }
+
+    uint8_t* pairs(int x, int y) {  // the byte holding (x, y)
+        return m_bytes + (size_t)x * m_stride + ((y + m_lead) >> 1);
+    }
+
+    PackedView view() const {
+        return { m_bytes, m_columns, m_rows, m_stride, m_lead };
+    }
+};
+
+inline int PopCount(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (int)__popcnt64(bits);
+#elif defined(__GNUC__)
+    return __builtin_popcountll(bits);
+#else
+    return (int)std::bitset<64>(bits).count();
+#endif
+}
+
+enum SimdLevel {
+    SIMD_NONE,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+const char* SimdLevelName(int level) {
+    switch (level) {
+    case SIMD_SSE2:
+        return "SSE2";
+    case SIMD_AVX2:
+        return "AVX2";
+    case SIMD_AVX512:
+        return "AVX-512";
+    default:
+        return "none";
     }
+}
 
-    void set_first(int x, int y, int value) {
-        m_first[x][y] = value;
+// Vectorised neighbourhood test for the cells [0, count) of one column, starting at column. offsets are
+// Neighbourhood::offsets(). successors[i] gets the successor of cell i when at least threshold neighbours
+// hold it, -1 otherwise. Whole vectors are processed, so up to one vector past count is read and written.
+typedef void (*SimdColumnKernel)(const int8_t* column, int count, const int* offsets, int offsetCount, int colorNumber, int threshold, int8_t* successors);
+
+// The same test on a packed column, where byte k holds an even row in its low nibble and the next row in its high
+// nibble. Each loaded byte is split into a vector of even rows and a vector of odd rows, so a vector covers twice
+// the cells of SimdColumnKernel. A neighbour at an even row offset j sits in the same nibble of byte k + j / 2, one
+// at an odd offset in the other nibble, of byte k + (j - 1) / 2 for the even rows and k + (j + 1) / 2 for the odd ones.
+// columnFirst and columnLast give the rows of the shape in each column i, at index i + range; the columns of the
+// packed grid are columnStride bytes apart. lowSuccessors[k] and highSuccessors[k] get the result for the two
+// cells of byte k, as in SimdColumnKernel. Whole vectors are processed, up to one vector past bytes.
+typedef void (*PackedColumnKernel)(const uint8_t* column, int bytes, int columnStride, const int* columnFirst, const int* columnLast, int range,
+    int colorNumber, int threshold, int8_t* lowSuccessors, int8_t* highSuccessors);
+
+#if defined(CCA_X86)
+#if defined(__GNUC__)
+#define CCA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CCA_TARGET(isa)
+#endif
+
+// Reads CPUID, and XCR0 to check that the OS saves the wider registers on a context switch
+int DetectSimdLevel() {
+    unsigned int regs[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+    __cpuid((int*)regs, 0);
+#else
+    __cpuid(0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    unsigned int maxLeaf = regs[0];
+
+#if defined(_MSC_VER)
+    __cpuid((int*)regs, 1);
+#else
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    if (!(regs[3] & (1u << 26))) return SIMD_NONE;                      // SSE2
+    if (!(regs[2] & (1u << 27)) || maxLeaf < 7) return SIMD_SSE2;       // OSXSAVE
+
+#if defined(_MSC_VER)
+    uint64_t xcr0 = _xgetbv(0);
+#else
+    unsigned int xcr0Low, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    uint64_t xcr0 = ((uint64_t)xcr0High << 32) | xcr0Low;
+#endif
+
+#if defined(_MSC_VER)
+    __cpuidex((int*)regs, 7, 0);
+#else
+    __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    bool avx512 = (regs[1] & (1u << 16)) && (regs[1] & (1u << 30)); // AVX-512F and BW
+    bool avx2 = regs[1] & (1u << 5);
+    if (avx512 && (xcr0 & 0xE6) == 0xE6) return SIMD_AVX512;         // XMM, YMM, opmask and ZMM state
+    if (avx2 && (xcr0 & 0x6) == 0x6) return SIMD_AVX2;              // XMM and YMM state
+    return SIMD_SSE2;
+}
+
+CCA_TARGET("sse2")
+void SimdColumnSSE2(const int8_t* column, int count, const int* offsets, int offsetCount, int colorNumber, int threshold, int8_t* successors) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i none = _mm_set1_epi8(-1);
+    const __m128i last = _mm_set1_epi8((char)(colorNumber - 1));
+    const __m128i limit = _mm_set1_epi8((char)threshold);
+    for (int y = 0; y < count; y += 16) {
+        __m128i cells = _mm_loadu_si128((const __m128i*)(column + y));
+        __m128i successor = _mm_andnot_si128(_mm_cmpeq_epi8(cells, last), _mm_add_epi8(cells, one));
+        __m128i found = _mm_setzero_si128();
+        __m128i reached = _mm_setzero_si128();
+        for (int n = 0; n < offsetCount; n++) {
+            __m128i neighbours = _mm_loadu_si128((const __m128i*)(column + y + offsets[n]));
+            found = _mm_adds_epu8(found, _mm_and_si128(_mm_cmpeq_epi8(neighbours, successor), one));    // saturates at 255
+            if ((n & 7) == 7 || n == offsetCount - 1) {
+                reached = _mm_cmpeq_epi8(_mm_max_epu8(found, limit), found);  // unsigned found >= threshold
+                if (_mm_movemask_epi8(reached) == 0xFFFF) break;
+            }
+        }
+        _mm_storeu_si128((__m128i*)(successors + y), _mm_or_si128(_mm_and_si128(reached, successor), _mm_andnot_si128(reached, none)));
     }
+}
 
-    void set_curr(int x, int y, int value) {
-        if (m_first_curr) {
-            m_first[x][y] = value;
+CCA_TARGET("avx2")
+void SimdColumnAVX2(const int8_t* column, int count, const int* offsets, int offsetCount, int colorNumber, int threshold, int8_t* successors) {
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i none = _mm256_set1_epi8(-1);
+    const __m256i last = _mm256_set1_epi8((char)(colorNumber - 1));
+    const __m256i limit = _mm256_set1_epi8((char)threshold);
+    for (int y = 0; y < count; y += 32) {
+        __m256i cells = _mm256_loadu_si256((const __m256i*)(column + y));
+        __m256i successor = _mm256_andnot_si256(_mm256_cmpeq_epi8(cells, last), _mm256_add_epi8(cells, one));
+        __m256i found = _mm256_setzero_si256();
+        __m256i reached = _mm256_setzero_si256();
+        for (int n = 0; n < offsetCount; n++) {
+            __m256i neighbours = _mm256_loadu_si256((const __m256i*)(column + y + offsets[n]));
+            found = _mm256_adds_epu8(found, _mm256_and_si256(_mm256_cmpeq_epi8(neighbours, successor), one));
+            if ((n & 7) == 7 || n == offsetCount - 1) {
+                reached = _mm256_cmpeq_epi8(_mm256_max_epu8(found, limit), found);
+                if (_mm256_movemask_epi8(reached) == -1) break;
+            }
         }
-        else {
-            m_second[x][y] = value;
+        _mm256_storeu_si256((__m256i*)(successors + y), _mm256_blendv_epi8(none, successor, reached));
+    }
+}
+
+CCA_TARGET("avx512f,avx512bw")
+void SimdColumnAVX512(const int8_t* column, int count, const int* offsets, int offsetCount, int colorNumber, int threshold, int8_t* successors) {
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i none = _mm512_set1_epi8(-1);
+    const __m512i last = _mm512_set1_epi8((char)(colorNumber - 1));
+    const __m512i limit = _mm512_set1_epi8((char)threshold);
+    for (int y = 0; y < count; y += 64) {
+        __m512i cells = _mm512_loadu_si512((const void*)(column + y));
+        __m512i successor = _mm512_maskz_add_epi8(~_mm512_cmpeq_epi8_mask(cells, last), cells, one);
+        __m512i found = _mm512_setzero_si512();
+        __mmask64 reached = 0;
+        for (int n = 0; n < offsetCount; n++) {
+            __m512i neighbours = _mm512_loadu_si512((const void*)(column + y + offsets[n]));
+            found = _mm512_mask_adds_epu8(found, _mm512_cmpeq_epi8_mask(neighbours, successor), found, one);
+            if ((n & 7) == 7 || n == offsetCount - 1) {
+                reached = _mm512_cmpge_epu8_mask(found, limit);
+                if (reached == ~(__mmask64)0) break;
+            }
         }
+        _mm512_storeu_si512((void*)(successors + y), _mm512_mask_blend_epi8(reached, none, successor));
     }
+}
 
-    void set_next(int x, int y, int value) {
-        if (!m_first_curr) {
-            m_first[x][y] = value;
+CCA_TARGET("sse2")
+void PackedColumnSSE2(const uint8_t* column, int bytes, int columnStride, const int* columnFirst, const int* columnLast, int range,
+    int colorNumber, int threshold, int8_t* lowSuccessors, int8_t* highSuccessors) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i none = _mm_set1_epi8(-1);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i last = _mm_set1_epi8((char)(colorNumber - 1));
+    const __m128i limit = _mm_set1_epi8((char)threshold);
+    for (int k = 0; k < bytes; k += 16) {
+        __m128i pairs = _mm_loadu_si128((const __m128i*)(column + k));
+        __m128i cellsLow = _mm_and_si128(pairs, nibble);
+        __m128i cellsHigh = _mm_and_si128(_mm_srli_epi16(pairs, 4), nibble);
+        __m128i successorLow = _mm_andnot_si128(_mm_cmpeq_epi8(cellsLow, last), _mm_add_epi8(cellsLow, one));
+        __m128i successorHigh = _mm_andnot_si128(_mm_cmpeq_epi8(cellsHigh, last), _mm_add_epi8(cellsHigh, one));
+        __m128i foundLow = _mm_setzero_si128();
+        __m128i foundHigh = _mm_setzero_si128();
+        __m128i reachedLow = _mm_setzero_si128();
+        __m128i reachedHigh = _mm_setzero_si128();
+        for (int i = -range; i <= range; i++) {
+            const uint8_t* neighbours = column + (ptrdiff_t)i * columnStride + k;
+            for (int j = columnFirst[i + range]; j <= columnLast[i + range]; j++) {
+                __m128i low, high;
+                if (j & 1) {
+                    low = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(neighbours + ((j - 1) >> 1))), 4), nibble);
+                    high = _mm_and_si128(_mm_loadu_si128((const __m128i*)(neighbours + ((j + 1) >> 1))), nibble);
+                }
+                else {
+                    __m128i neighbourPairs = _mm_loadu_si128((const __m128i*)(neighbours + (j >> 1)));
+                    low = _mm_and_si128(neighbourPairs, nibble);
+                    high = _mm_and_si128(_mm_srli_epi16(neighbourPairs, 4), nibble);
+                }
+                foundLow = _mm_adds_epu8(foundLow, _mm_and_si128(_mm_cmpeq_epi8(low, successorLow), one));
+                foundHigh = _mm_adds_epu8(foundHigh, _mm_and_si128(_mm_cmpeq_epi8(high, successorHigh), one));
+            }
+            reachedLow = _mm_cmpeq_epi8(_mm_max_epu8(foundLow, limit), foundLow);
+            reachedHigh = _mm_cmpeq_epi8(_mm_max_epu8(foundHigh, limit), foundHigh);
+            if (_mm_movemask_epi8(_mm_and_si128(reachedLow, reachedHigh)) == 0xFFFF) break;
         }
-        else {
-            m_second[x][y] = value;
+        _mm_storeu_si128((__m128i*)(lowSuccessors + k), _mm_or_si128(_mm_and_si128(reachedLow, successorLow), _mm_andnot_si128(reachedLow, none)));
+        _mm_storeu_si128((__m128i*)(highSuccessors + k), _mm_or_si128(_mm_and_si128(reachedHigh, successorHigh), _mm_andnot_si128(reachedHigh, none)));
+    }
+}
+
+CCA_TARGET("avx2")
+void PackedColumnAVX2(const uint8_t* column, int bytes, int columnStride, const int* columnFirst, const int* columnLast, int range,
+    int colorNumber, int threshold, int8_t* lowSuccessors, int8_t* highSuccessors) {
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i none = _mm256_set1_epi8(-1);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i last = _mm256_set1_epi8((char)(colorNumber - 1));
+    const __m256i limit = _mm256_set1_epi8((char)threshold);
+    for (int k = 0; k < bytes; k += 32) {
+        __m256i pairs = _mm256_loadu_si256((const __m256i*)(column + k));
+        __m256i cellsLow = _mm256_and_si256(pairs, nibble);
+        __m256i cellsHigh = _mm256_and_si256(_mm256_srli_epi16(pairs, 4), nibble);
+        __m256i successorLow = _mm256_andnot_si256(_mm256_cmpeq_epi8(cellsLow, last), _mm256_add_epi8(cellsLow, one));
+        __m256i successorHigh = _mm256_andnot_si256(_mm256_cmpeq_epi8(cellsHigh, last), _mm256_add_epi8(cellsHigh, one));
+        __m256i foundLow = _mm256_setzero_si256();
+        __m256i foundHigh = _mm256_setzero_si256();
+        __m256i reachedLow = _mm256_setzero_si256();
+        __m256i reachedHigh = _mm256_setzero_si256();
+        for (int i = -range; i <= range; i++) {
+            const uint8_t* neighbours = column + (ptrdiff_t)i * columnStride + k;
+            for (int j = columnFirst[i + range]; j <= columnLast[i + range]; j++) {
+                __m256i low, high;
+                if (j & 1) {
+                    low = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(neighbours + ((j - 1) >> 1))), 4), nibble);
+                    high = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(neighbours + ((j + 1) >> 1))), nibble);
+                }
+                else {
+                    __m256i neighbourPairs = _mm256_loadu_si256((const __m256i*)(neighbours + (j >> 1)));
+                    low = _mm256_and_si256(neighbourPairs, nibble);
+                    high = _mm256_and_si256(_mm256_srli_epi16(neighbourPairs, 4), nibble);
+                }
+                foundLow = _mm256_adds_epu8(foundLow, _mm256_and_si256(_mm256_cmpeq_epi8(low, successorLow), one));
+                foundHigh = _mm256_adds_epu8(foundHigh, _mm256_and_si256(_mm256_cmpeq_epi8(high, successorHigh), one));
+            }
+            reachedLow = _mm256_cmpeq_epi8(_mm256_max_epu8(foundLow, limit), foundLow);
+            reachedHigh = _mm256_cmpeq_epi8(_mm256_max_epu8(foundHigh, limit), foundHigh);
+            if (_mm256_movemask_epi8(_mm256_and_si256(reachedLow, reachedHigh)) == -1) break;
         }
+        _mm256_storeu_si256((__m256i*)(lowSuccessors + k), _mm256_blendv_epi8(none, successorLow, reachedLow));
+        _mm256_storeu_si256((__m256i*)(highSuccessors + k), _mm256_blendv_epi8(none, successorHigh, reachedHigh));
     }
+}
 
-    int get_curr(int x, int y) {
-        if (m_first_curr) {
-            return m_first[x][y];
+// With AVX-512 the nibbles are compared in place: a ^ successor has a zero nibble where they match, which
+// vptestnmb turns into a mask. Odd offsets compare against the successors shifted by one nibble instead.
+CCA_TARGET("avx512f,avx512bw")
+void PackedColumnAVX512(const uint8_t* column, int bytes, int columnStride, const int* columnFirst, const int* columnLast, int range,
+    int colorNumber, int threshold, int8_t* lowSuccessors, int8_t* highSuccessors) {
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i none = _mm512_set1_epi8(-1);
+    const __m512i lowNibble = _mm512_set1_epi8(0x0F);
+    const __m512i highNibble = _mm512_set1_epi8((char)0xF0);
+    const __m512i last = _mm512_set1_epi8((char)(colorNumber - 1));
+    const __m512i limit = _mm512_set1_epi8((char)threshold);
+    for (int k = 0; k < bytes; k += 64) {
+        __m512i pairs = _mm512_loadu_si512((const void*)(column + k));
+        __m512i cellsLow = _mm512_and_si512(pairs, lowNibble);
+        __m512i cellsHigh = _mm512_and_si512(_mm512_srli_epi16(pairs, 4), lowNibble);
+        __m512i successorLow = _mm512_maskz_add_epi8(~_mm512_cmpeq_epi8_mask(cellsLow, last), cellsLow, one);
+        __m512i successorHigh = _mm512_maskz_add_epi8(~_mm512_cmpeq_epi8_mask(cellsHigh, last), cellsHigh, one);
+        __m512i successors = _mm512_or_si512(_mm512_and_si512(successorLow, lowNibble),    // packed again, the halo value of a clamped
+            _mm512_slli_epi16(_mm512_and_si512(successorHigh, lowNibble), 4));               // grid would carry into the other nibble
+        __m512i successorsUp = _mm512_slli_epi16(_mm512_and_si512(successorLow, lowNibble), 4);    // the low successors in the high nibbles
+        __m512i foundLow = _mm512_setzero_si512();
+        __m512i foundHigh = _mm512_setzero_si512();
+        __mmask64 reachedLow = 0;
+        __mmask64 reachedHigh = 0;
+        for (int i = -range; i <= range; i++) {
+            const uint8_t* neighbours = column + (ptrdiff_t)i * columnStride + k;
+            for (int j = columnFirst[i + range]; j <= columnLast[i + range]; j++) {
+                if (j & 1) {
+                    __m512i below = _mm512_xor_si512(_mm512_loadu_si512((const void*)(neighbours + ((j - 1) >> 1))), successorsUp);
+                    __m512i above = _mm512_xor_si512(_mm512_loadu_si512((const void*)(neighbours + ((j + 1) >> 1))), successorHigh);
+                    foundLow = _mm512_mask_adds_epu8(foundLow, _mm512_testn_epi8_mask(below, highNibble), foundLow, one);
+                    foundHigh = _mm512_mask_adds_epu8(foundHigh, _mm512_testn_epi8_mask(above, lowNibble), foundHigh, one);
+                }
+                else {
+                    __m512i matches = _mm512_xor_si512(_mm512_loadu_si512((const void*)(neighbours + (j >> 1))), successors);
+                    foundLow = _mm512_mask_adds_epu8(foundLow, _mm512_testn_epi8_mask(matches, lowNibble), foundLow, one);
+                    foundHigh = _mm512_mask_adds_epu8(foundHigh, _mm512_testn_epi8_mask(matches, highNibble), foundHigh, one);
+                }
+            }
+            reachedLow = _mm512_cmpge_epu8_mask(foundLow, limit);
+            reachedHigh = _mm512_cmpge_epu8_mask(foundHigh, limit);
+            if ((reachedLow & reachedHigh) == ~(__mmask64)0) break;
         }
-        else {
-            return m_second[x][y];
+        _mm512_storeu_si512((void*)(lowSuccessors + k), _mm512_mask_blend_epi8(reachedLow, none, successorLow));
+        _mm512_storeu_si512((void*)(highSuccessors + k), _mm512_mask_blend_epi8(reachedHigh, none, successorHigh));
+    }
+}
+#else
+int DetectSimdLevel() {
+    return SIMD_NONE;
+}
+#endif
+
+// The cells around (0, 0) that count as neighbours, stored as linear offsets into a state buffer
+// so the stepping loop can walk a flat list instead of testing the shape for every offset.
+class Neighbourhood {
+private:
+    int m_range = 0;
+    std::vector<int> m_offsets;
+    std::vector<int> m_columnFirst; // for each column i, the first and last j of the shape (every shape is convex along a column)
+    std::vector<int> m_columnLast;
+public:
+    static bool contains(int shape, int range, int i, int j) {
+        switch (shape) {
+        case MOORE:
+            return true;
+        case CIRCULAR:
+            return i * i + j * j <= range * range;
+        case CROSS:
+            return i == 0 || j == 0;
+        case HEXAGONAL:
+            return std::abs(i + j) <= range;
+        default:
+            return std::abs(i) + std::abs(j) <= range;
         }
     }
 
-    void swap_arrays() {
-        m_first_curr = !m_first_curr;
+    void build(int shape, int range, int stride) {  // stride: distance between (x, y) and (x + 1, y) in the buffer
+        m_range = range;
+        m_offsets.clear();
+        m_columnFirst.assign(2 * range + 1, range + 1);
+        m_columnLast.assign(2 * range + 1, -range - 1);
+        for (int i = -range; i <= range; i++)
+            for (int j = -range; j <= range; j++)
+                if (contains(shape, range, i, j)) {
+                    m_offsets.push_back(i * stride + j);
+                    m_columnFirst[i + range] = std::min(m_columnFirst[i + range], j);
+                    m_columnLast[i + range] = std::max(m_columnLast[i + range], j);
+                }
+    }
+
+    const std::vector<int>& offsets() const {
+        return m_offsets;
+    }
+
+    const int* column_firsts() const {     // column_first(i) for every i, at index i + range
+        return m_columnFirst.data();
     }
 
-    std::array<std::array<int, TOT_SIZE>, TOT_SIZE> get_next() {
-        if (m_first_curr) {
-            return m_second;
+    const int* column_lasts() const {
+        return m_columnLast.data();
+    }
+
+    int column_first(int i) const {
+        return m_columnFirst[i + m_range];
+    }
+
+    int column_last(int i) const {
+        return m_columnLast[i + m_range];
+    }
+};
+
+// Persistent workers that run the tasks of a job in parallel. The calling thread works too, as worker 0,
+// and run() returns once every task of the job is done, so each generation ends with a join.
+// The tasks are dealt out in contiguous blocks, one per worker. A worker takes its own tasks from the front
+// of its block; once it runs dry it steals the back half of the fullest block it finds, so the load evens
+// out however uneven the tasks are. The blocks are ranges of task numbers, which keeps each deque a pair of ints.
+class ThreadPool {
+public:
+    struct Counters {
+        double busySeconds = 0;     // time spent inside tasks
+        double idleSeconds = 0;     // time spent looking for work or waiting for the others to finish
+        long long tasks = 0;
+        long long steals = 0;
+    };
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        int front = 0;
+        int back = 0;               // the queue holds the tasks [front, back)
+    };
+
+    std::vector<std::thread> m_threads;
+    std::vector<TaskQueue> m_queues;
+    std::vector<Counters> m_counters;
+    std::vector<double> m_jobBusy;  // busy seconds of each worker in the current job
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(int, int)>* m_job = nullptr;
+    int m_working = 0;              // helper threads that have not finished the current job yet
+    unsigned m_jobNumber = 0;
+    bool m_stop = false;
+
+    bool pop(int worker, int& task) {
+        TaskQueue& queue = m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.front == queue.back) return false;
+        task = queue.front++;
+        return true;
+    }
+
+    bool steal(int worker) {
+        int victim = -1;
+        int most = 0;
+        for (int i = 1; i < (int)m_queues.size(); i++) {
+            int other = (worker + i) % (int)m_queues.size();
+            std::lock_guard<std::mutex> lock(m_queues[other].mutex);
+            if (m_queues[other].back - m_queues[other].front > most) {
+                most = m_queues[other].back - m_queues[other].front;
+                victim = other;
+            }
+        }
+        if (victim < 0) return false;
+
+        int first, last;
+        {
+            std::lock_guard<std::mutex> lock(m_queues[victim].mutex);
+            TaskQueue& queue = m_queues[victim];
+            if (queue.front == queue.back) return true;     // emptied meanwhile, look again
+            last = queue.back;
+            first = queue.back - (queue.back - queue.front + 1) / 2;
+            queue.back = first;
+        }
+        std::lock_guard<std::mutex> lock(m_queues[worker].mutex);
+        m_queues[worker].front = first;
+        m_queues[worker].back = last;
+        m_counters[worker].steals++;
+        return true;
+    }
+
+    void work(int worker) {
+        double busy = 0;
+        int task;
+        do {
+            while (pop(worker, task)) {
+                auto start = std::chrono::steady_clock::now();
+                (*m_job)(task, worker);
+                busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                m_counters[worker].tasks++;
+            }
+        } while (steal(worker));    // tasks never spawn tasks, so once every queue is empty the job is done
+        m_jobBusy[worker] = busy;
+    }
+
+    void loop(int worker) {
+        unsigned jobNumber = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_jobNumber != jobNumber; });
+                if (m_stop) return;
+                jobNumber = m_jobNumber;
+            }
+            work(worker);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_working == 0) m_done.notify_one();
+        }
+    }
+
+public:
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& thread : m_threads) thread.join();
+    }
+
+    void start(int threads) {   // threads counts the caller, so start(1) runs everything on the calling thread
+        std::vector<TaskQueue>(threads).swap(m_queues);
+        m_counters.assign(threads, {});
+        m_jobBusy.assign(threads, 0);
+        for (int worker = 1; worker < threads; worker++)
+            m_threads.emplace_back(&ThreadPool::loop, this, worker);
+    }
+
+    int size() const {
+        return (int)m_queues.size();
+    }
+
+    const Counters& counters(int worker) const {
+        return m_counters[worker];
+    }
+
+    // calls job(task, worker) for every task in [0, tasks), worker being in [0, size())
+    void run(int tasks, const std::function<void(int task, int worker)>& job) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            for (int worker = 0; worker < size(); worker++) {
+                m_queues[worker].front = tasks * worker / size();
+                m_queues[worker].back = tasks * (worker + 1) / size();
+            }
+            m_working = (int)m_threads.size();
+            m_jobNumber++;
         }
-        else {
-            return m_first;
+        m_wake.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_working == 0; });
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (int worker = 0; worker < size(); worker++) {
+            m_counters[worker].busySeconds += m_jobBusy[worker];
+            m_counters[worker].idleSeconds += elapsed - m_jobBusy[worker];
         }
     }
 };
 
+// A cell that transitions in the current generation
+struct Change {
+    int x, y;
+    int state;              // the successor it turns into
+};
+
+// A rectangle of inner cells, the unit of work handed to the thread pool
+struct Tile {
+    int xFirst, xLast;      // columns [xFirst, xLast)
+    int yFirst, yLast;      // rows [yFirst, yLast)
+};
+
 class CCA : public olc::PixelGameEngine
 {
 private:
 	int range = RANGE;
 	int threshold = THRESHOLD;
 	int colorNumber = COLORS;
-	bool moore = NH;
+	int shape = NH;
+	int engine = ENGINE;
+	int threadCount = THREADS;
 	std::vector<Color> colorPalette = {};
-    int successorIndex;
+    std::vector<int> successorTable;    // successor of each state, one load per cell instead of a comparison
+    std::vector<uint32_t> pixelTable;   // colorPalette[state] packed as an olc::Pixel, what PresentRows writes
+    Neighbourhood neighbourhood;    // offsets of the active shape, built once in OnUserCreate
+    SimdColumnKernel simdColumn = nullptr;  // simd: the widest kernel the CPU supports
+    PackedColumnKernel packedColumn = nullptr;  // packed: the same for the packed kernels
+    std::vector<uint64_t> bitplanes;    // bitplane: for each state and column x, one bit per y, with a zero word before and after
+    std::vector<Cell> rotatedStates;        // diamond: the grid turned by 45 degrees, one table per parity of x + y
+    struct Scratch {                    // buffers each worker thread keeps to itself
+        std::vector<int> stripCounts;   // sliding window: per row, how many cells of each state lie in the 2*range+1 columns around x
+        std::vector<int> windowCounts;  // sliding window: how many cells of each state lie in the whole square around (x, y)
+        std::vector<uint16_t> diamondSums;      // diamond: summed-area tables of one state over rotatedStates
+        std::vector<std::vector<int>> cellsBySuccessor; // diamond: inner cells (x * stride + y) of the band grouped by their successor state
+        std::vector<int8_t> simdSuccessors;     // simd: result of one column, with room for a whole vector past its end
+        std::vector<int8_t> lowSuccessors;      // packed: result of one column for the low and the high nibbles, same room
+        std::vector<int8_t> highSuccessors;
+        std::vector<Change> changes;    // the transitions this worker found in the current generation
+    };
+    std::vector<Scratch> scratch;   // one per worker of the pool
+    void (CCA::*specialisedStep)(const Tile&, const GridView&, Scratch&) = nullptr;   // specialised: the kernel instance picked for the active rule
+    ThreadPool pool;
+    std::vector<Tile> tiles;        // the inner cells, one task each
+    std::vector<std::vector<int>> tileNeighbours;   // for each tile, the tiles (itself included) holding cells within range of it
+    std::vector<char> tileChanged;  // whether any cell of the tile transitioned in the last generation
+    std::vector<char> tileActive;   // whether the tile can transition this generation, i.e. a tile near it changed
+    int tilesPerColumn = 1;         // tiles stacked along y, tile t covers column block t / tilesPerColumn
+    long long activeTileSum = 0;    // active tiles summed over every generation, for the average active fraction
+    long long generations = 0;
+    int bandCount = 1;              // whole columns split into this many bands, for the passes that prepare a generation
+	int gridWidth = GRID_WIDTH;
+	int gridHeight = GRID_HEIGHT;
+	int viewX = 0;      // first column and row of the grid shown in the window
+	int viewY = 0;
+	int boundary = BOUNDARY;
+	int pad = 0;        // ghost cells around the grid, as deep as the range so no neighbourhood leaves the arrays
+	int columns = 0;    // size of the arrays, halo included
+	int rows = 0;
+	int stride = 0;     // distance between (x, y) and (x + 1, y) in the arrays
+	int xStartIndex = 0;    // starting and ending iteration after and before the halo
+	int xEndIndex = 0;
+	int yStartIndex = 0;
+	int yEndIndex = 0;
+	int rotatedRows = 0;    // diamond: size of each rotated table
+	int rotatedColumns = 0;
+	int rotatedShift = 0;   // diamond: keeps x - y positive and of the same parity as x + y
+	int planeWords = 0;     // bitplane: words per column of a bitplane, padding included
 	static const int margin = MARGIN;
 	static const int border = BORDER;
 	static const int textureWidth = INNER_SIZE + (2 * margin) + (2 * border);
 	static const int textureHeight = INNER_SIZE + (2 * margin) + (2 * border);
-	static const int xStartIndex = margin + border; // starting and ending iteration after and before the borders
-	static const int xEndIndex = textureWidth - margin - border;
-	static const int yStartIndex = margin + border;
-	static const int yEndIndex = textureHeight - margin - border;
-    DoubleArray stateArrays; //using 2 alternaticing arrays, 1 to read from and 1 to write to
+	static const int screenStart = margin + border; // where the grid starts in the window
+	int frameLayer = 0;     // layer holding the frame, drawn once in DrawFrame
+	std::chrono::steady_clock::time_point runStart;     // end of OnUserCreate, for the speed printed on exit
+    CellGrid stateGrid; //a single generation, the changes of each are written back in OnUserUpdate
+    PackedGrid packedGrid;  // packed: the grid in its place, two cells per byte
 
 public:
 	CCA()
@@ -113,87 +890,897 @@ public:
 	{
 		// Called once at the start, so create things here
         std::cout << "Active Rule: R" << range << ", T" << threshold << ", C" << colorNumber;
-        if (moore) std::cout << ", Moore" << std::endl;
+        if (shape == MOORE) std::cout << ", Moore" << std::endl;
+        else if (shape == CIRCULAR) std::cout << ", Circular" << std::endl;
+        else if (shape == CROSS) std::cout << ", Cross" << std::endl;
+        else if (shape == HEXAGONAL) std::cout << ", Hexagonal" << std::endl;
         else std::cout << ", vonNeumann" << std::endl;
+        SetupThreads(); // starts the worker threads, they help allocate the grid and step every generation
+        SetupGrid();    // sizes the grid and its halo
+        SetupEngine();  // checks that the chosen engine supports the rule and allocates its buffers
+        AllocateGrid(); // as cells, or as nibbles for the packed engine
+        neighbourhood.build(shape, range, stride);
         SetupColors();  // the color palette is set based upon the number of states selected by the user
+        SetupStateTables(); // successor and pixel of every state, looked up instead of computed
+        DrawFrame();    // on a layer of its own, the cells are drawn on layer 0
         RandomizeTexture(); // creates the initial grid of cells randomly
-        stateArrays.copy(); // copy the values of the array to its clone
+        RefreshHalo();
+        PresentGrid();
+        runStart = std::chrono::steady_clock::now();
 		return true;
 	}
 
 	bool OnUserUpdate(float fElapsedTime) override
 	{
 		// called once per frame
-		stateArrays.swap_arrays();    // alternate using the 2 arrays for reading and writing
-		for (int x = xStartIndex; x < xEndIndex; x++)
-		{                                                   // for every cell (pixel) in the grid
-			for (int y = yStartIndex; y < yEndIndex; y++)
+		// The engines only read the grid and list the cells that transition. The lists are written back once
+		// every cell has been evaluated, so every engine reads one whole generation from a single array and
+		// nothing but the changed cells is written. The window is then redrawn from the grid in one pass.
+		UpdateActiveTiles();
+		for (Scratch& buffers : scratch)
+			buffers.changes.clear();
+
+		if (engine == DIAMOND)
+		{
+			for (Scratch& buffers : scratch)
+				for (auto& cells : buffers.cellsBySuccessor) cells.clear();
+			pool.run(bandCount, [&](int band, int worker) { DiamondRotate(BandStart(band, 0, columns), BandStart(band + 1, 0, columns), worker); });
+			pool.run(colorNumber, [&](int state, int worker) { DiamondStep(state, worker); });
+		}
+		else
+		{
+			if (engine == BITPLANE)
+				pool.run(bandCount, [&](int band, int worker) { BuildBitplanes(BandStart(band, 0, columns), BandStart(band + 1, 0, columns)); });
+
+			pool.run((int)tiles.size(), [&](int task, int worker) {
+				const Tile& tile = tiles[task];
+				if (!tileActive[task]) return;  // nothing within range changed, so neither will the tile
+
+				Scratch& buffers = scratch[worker];
+				size_t before = buffers.changes.size();
+
+				GridView cells = stateGrid.view();
+				if (engine == SLIDING_WINDOW) SlidingWindowStep(tile, cells, buffers);
+				else if (engine == SPECIALISED) (this->*specialisedStep)(tile, cells, buffers);
+				else if (engine == BITPLANE) BitplaneStep(tile, buffers);
+				else if (engine == SIMD) SimdStep(tile, cells, buffers);
+				else if (engine == PACKED) PackedStep(tile, buffers);
+				else EarlyExitStep(tile, cells, buffers);
+				tileChanged[task] = buffers.changes.size() > before;
+			});
+		}
+
+		pool.run(pool.size(), [&](int list, int worker) { ApplyChanges(scratch[list].changes); });
+		RefreshHalo();
+		if (engine == DIAMOND)
+			for (const Scratch& buffers : scratch)
+				for (const Change& change : buffers.changes)
+					tileChanged[TileOf(change.x, change.y)] = true;
+		PresentGrid();
+		return true;
+	}
+
+	// The generation the last OnUserUpdate produced, read in place. Only the grid is in view, from (0, 0)
+	// to (gridWidth - 1, gridHeight - 1): the halo is left out, so every cell holds a live state.
+	GenerationView LatestGeneration() const
+	{
+		if (engine == PACKED)
+		{
+			PackedView curr = packedGrid.view();
+			return { { nullptr, 0, 0, 0 }, { curr.data + (size_t)xStartIndex * curr.stride, gridWidth, gridHeight, curr.stride, curr.first + yStartIndex },
+				gridWidth, gridHeight };
+		}
+		GridView curr = stateGrid.view();
+		return { { curr.cell(xStartIndex, yStartIndex), gridWidth, gridHeight, curr.stride }, { nullptr, 0, 0, 0, 0 }, gridWidth, gridHeight };
+	}
+
+	double ActiveFraction() const   // average share of the tiles evaluated per generation
+	{
+		return generations ? (double)activeTileSum / ((double)generations * tiles.size()) : 1.0;
+	}
+
+	// Returns the time PresentGrid takes to draw the window from a grid of the given size
+	static double PresentMilliseconds(int width, int height)
+	{
+		olc::Sprite screen(TOT_SIZE, TOT_SIZE);
+		CCA* app = new CCA();
+		app->gridWidth = width;
+		app->gridHeight = height;
+		app->SetDrawTarget(&screen);
+		app->OnUserCreate();
+		app->PresentGrid();     // warm up
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < 100; frame++) app->PresentGrid();
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		delete app;
+		return elapsed / 100;
+	}
+
+	// Prints the time to draw the window at a few grid sizes
+	static void PresentBenchmark()
+	{
+		const int sizes[] = { 540, 2048, 4096 };
+		for (int size : sizes)
+		{
+			double milliseconds = PresentMilliseconds(size, size);
+			std::cout << "Present, " << size << " x " << size << ": " << milliseconds << " ms per frame" << std::endl;
+		}
+	}
+
+	bool OnUserDestroy() override
+	{
+		for (int worker = 0; worker < pool.size(); worker++)
+		{                                                   // how evenly the work was spread
+			const ThreadPool::Counters& counters = pool.counters(worker);
+			std::cout << "Thread " << worker << ": busy " << counters.busySeconds << " s, idle " << counters.idleSeconds
+				<< " s, " << counters.tasks << " tasks, " << counters.steals << " steals" << std::endl;
+		}
+		std::cout << "Active tiles: " << 100.0 * ActiveFraction() << "% on average" << std::endl;
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+		std::cout << generations << " generations in " << elapsed << " s: " << generations / elapsed << " generations per second" << std::endl;
+		return true;
+	}
+
+private:
+	// A cell can only transition when a cell within range of it changed in the last generation,
+	// so a tile is evaluated only when it or a tile close enough to it changed.
+	void UpdateActiveTiles()
+	{
+		int active = 0;
+		for (int t = 0; t < (int)tiles.size(); t++)
+		{
+			tileActive[t] = false;
+			for (int neighbour : tileNeighbours[t])
+				tileActive[t] = tileActive[t] || tileChanged[neighbour];
+			active += tileActive[t];
+		}
+		std::fill(tileChanged.begin(), tileChanged.end(), false);
+		activeTileSum += active;
+		generations++;
+	}
+
+	int TileOf(int x, int y) const
+	{
+		return (x - xStartIndex) / TILE_SIZE * tilesPerColumn + (y - yStartIndex) / TILE_SIZE;
+	}
+
+	int BandStart(int band, int first, int last) const  // first column of a band when [first, last) is split into bandCount bands
+	{
+		return first + (last - first) * band / bandCount;
+	}
+
+	void EarlyExitStep(const Tile& tile, const GridView& cells, Scratch& buffers)
+	{
+		int successorIndex;
+		for (int x = tile.xFirst; x < tile.xLast; x++)
+		{                                                   // for every cell (pixel) in the tile
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+			{
+				successorIndex = successorTable[cells.at(x, y)];    // decide which the successor state is
+
+				if (NeighbourhoodAlgorithm(cells.cell(x, y), successorIndex))   // check whether there are enough neighbours with the successor state around
+					Transition(buffers, x, y, successorIndex);
+			}
+		}
+	}
+
+	// Same result as EarlyExitStep, but the cost per cell does not depend on the range.
+	// The halo of a clamped grid holds colorNumber, which gets a bin of its own.
+	void SlidingWindowStep(const Tile& tile, const GridView& cells, Scratch& buffers)
+	{
+		const int bins = colorNumber + 1;
+		const int xFirst = tile.xFirst;
+		const int xLast = tile.xLast;
+		const int yFirst = tile.yFirst - range;   // rows covered by the windows of the tile's cells
+		const int yLast = tile.yLast + range;
+		std::vector<int>& stripCounts = buffers.stripCounts;
+		std::vector<int>& windowCounts = buffers.windowCounts;
+		int successorIndex;
+
+		std::fill(stripCounts.begin() + yFirst * bins, stripCounts.begin() + yLast * bins, 0);
+		for (int y = yFirst; y < yLast; y++)
+			for (int i = xFirst - range; i <= xFirst + range; i++)
+				stripCounts[y * bins + cells.at(i, y)]++;
+
+		for (int x = xFirst; x < xLast; x++)
+		{
+			if (x > xFirst)
+			{
+				for (int y = yFirst; y < yLast; y++)
+				{                                           // move the strips one column to the right
+					stripCounts[y * bins + cells.at(x + range, y)]++;
+					stripCounts[y * bins + cells.at(x - range - 1, y)]--;
+				}
+			}
+
+			std::fill(windowCounts.begin(), windowCounts.end(), 0);
+			for (int y = tile.yFirst - range; y <= tile.yFirst + range; y++)
+				for (int s = 0; s < bins; s++)
+					windowCounts[s] += stripCounts[y * bins + s];
+
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+			{
+				if (y > tile.yFirst)
+				{                                           // move the window one row down
+					const int* incoming = &stripCounts[(y + range) * bins];
+					const int* outgoing = &stripCounts[(y - range - 1) * bins];
+					for (int s = 0; s < bins; s++)
+						windowCounts[s] += incoming[s] - outgoing[s];
+				}
+
+				successorIndex = successorTable[cells.at(x, y)];
+
+				if (windowCounts[successorIndex] >= threshold)
+					Transition(buffers, x, y, successorIndex);
+			}
+		}
+	}
+
+	// Same result as EarlyExitStep for vonNeumann, with a handful of lookups per cell whatever the range.
+	// The cells are split by the parity of x + y. Turned by 45 degrees each half is a plain grid of its own,
+	// indexed by a = (x + y) / 2 and b = (x - y + rotatedShift) / 2, in which a diamond is an axis aligned rectangle.
+	// The summed-area tables are 16 bits wide and allowed to wrap: the differences stay exact as long as
+	// a diamond holds fewer than 65536 cells.
+	// DiamondRotate fills rotatedStates for the columns [xFirst, xLast) and buckets their inner cells,
+	// then DiamondStep handles the cells of one successor state, so the states can be split among the workers.
+	void DiamondRotate(int xFirst, int xLast, int worker)
+	{
+		std::vector<std::vector<int>>& cellsBySuccessor = scratch[worker].cellsBySuccessor;
+		int successorIndex;
+		for (int x = xFirst; x < xLast; x++)
+		{
+			const Cell* column = stateGrid.column(x);
+			for (int y = 0; y < rows; y++)
 			{
-				if (stateArrays.get_curr(x, y) == colorNumber - 1) successorIndex = 0;
-				else successorIndex = stateArrays.get_curr(x, y) + 1;                   // decide which the successor state is
+				int state = column[y];
+				int parity = (x + y) & 1;
+				rotatedStates[((size_t)parity * rotatedRows + ((x + y) >> 1)) * rotatedColumns + ((x - y + rotatedShift) >> 1)] = state;
 
-				if (NeighbourhoodAlgorithm(x, y, successorIndex))   // check whether there are enough neighbours with the successor state around
+				if (x >= xStartIndex && x < xEndIndex && y >= yStartIndex && y < yEndIndex && tileActive[TileOf(x, y)])
 				{
-                    stateArrays.set_next(x, y, successorIndex);
-					Draw(x, y, olc::Pixel(colorPalette[stateArrays.get_curr(x, y)].red, colorPalette[stateArrays.get_curr(x, y)].green, colorPalette[stateArrays.get_curr(x, y)].blue));   // set the new value if yes
+					successorIndex = successorTable[state];
+					cellsBySuccessor[successorIndex].push_back(x * stride + y);
 				}
 			}
 		}
-		return true;
 	}
 
-private:
-	bool NeighbourhoodAlgorithm(int x, int y, int successorIndex)
+	void DiamondStep(int state, int worker)
 	{
-		int count = 0;
+		Scratch& own = scratch[worker];                                                       // one state per task, so the tables stay small enough for the cache
+		bool any = false;
+		for (const Scratch& buffers : scratch)
+			any = any || !buffers.cellsBySuccessor[state].empty();
+		if (!any) return;
 
-		for (int i = -range; i <= range; i++)
-		{                                           // check every cell around the current, in a range-sided square
-			for (int j = -range; j <= range; j++)
+		std::vector<uint16_t>& diamondSums = own.diamondSums;
+		for (int parity = 0; parity < 2; parity++)
+		{
+			const Cell* states = &rotatedStates[(size_t)parity * rotatedRows * rotatedColumns];
+			uint16_t* sums = &diamondSums[(size_t)parity * rotatedRows * rotatedColumns];
+			for (int a = 0; a < rotatedRows - 1; a++)
 			{
-				if (moore || ((std::abs(i) + std::abs(j)) <= range))   // if Moore is used then go ahead and check every cell in the square grid...
-				{                                                   // ... if not then check if the vonNeumann distance is within range
-					if (stateArrays.get_curr(x+i, y+j) == successorIndex) count++; // increase the total count of successor neighbours
-					if (count >= threshold) return true;    // return true if the count surpasses the threshold
+				uint16_t rowSum = 0;
+				for (int b = 0; b < rotatedColumns - 1; b++)
+				{
+					rowSum += states[(size_t)a * rotatedColumns + b] == state;
+					sums[(size_t)(a + 1) * rotatedColumns + b + 1] = sums[(size_t)a * rotatedColumns + b + 1] + rowSum;
 				}
 			}
 		}
-		return false;
+
+		for (const Scratch& buffers : scratch)
+		{
+			for (int cell : buffers.cellsBySuccessor[state])
+			{
+				int x = cell / stride;
+				int y = cell % stride;
+				int count = 0;
+				for (int parity = 0; parity < 2; parity++)
+				{
+					const uint16_t* sums = &diamondSums[(size_t)parity * rotatedRows * rotatedColumns];
+					int aFirst = (x + y - range - parity + 1) >> 1;                 // rows and columns of the rectangle, inclusive
+					int aLast = (x + y + range - parity) >> 1;
+					int bFirst = (x - y + rotatedShift - range - parity + 1) >> 1;
+					int bLast = (x - y + rotatedShift + range - parity) >> 1;
+					count += (uint16_t)(sums[(size_t)(aLast + 1) * rotatedColumns + bLast + 1] - sums[(size_t)aFirst * rotatedColumns + bLast + 1]
+						- sums[(size_t)(aLast + 1) * rotatedColumns + bFirst] + sums[(size_t)aFirst * rotatedColumns + bFirst]);
+				}
+				if (count >= threshold)
+					Transition(own, x, y, state);
+			}
+		}
 	}
 
-	void RandomizeTexture()
+	// Same result as EarlyExitStep, with the rule baked in at compile time. The neighbourhood loops have
+	// constant bounds the compiler can unroll, and the Moore/vonNeumann test folds away. Every neighbour
+	// is counted instead of exiting early, which keeps the unrolled body free of branches.
+	template<int Range, int Threshold, bool Moore>
+	void SpecialisedStep(const Tile& tile, const GridView& cells, Scratch& buffers)
 	{
-		int colorIndex;
-		Color color;
+		int successorIndex;
+		for (int x = tile.xFirst; x < tile.xLast; x++)
+		{
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+			{
+				successorIndex = successorTable[cells.at(x, y)];
 
-        // seed the random number generator with the current time
-        time_t  timev;
-        time(&timev);
-		srand(timev);
+				int count = 0;
+				for (int i = -Range; i <= Range; i++)
+					for (int j = -Range; j <= Range; j++)
+						if (Moore || ((std::abs(i) + std::abs(j)) <= Range))
+							count += cells.at(x + i, y + j) == successorIndex;
 
-		for (int x = 0; x < textureWidth; x++)
+				if (count >= Threshold)
+					Transition(buffers, x, y, successorIndex);
+			}
+		}
+	}
+
+	// Same result as EarlyExitStep. Once per generation each state gets a bitplane: per column x, one bit per y
+	// set where the cell holds that state. With threshold 1 a word of 64 cells is answered at once by ORing the
+	// plane of their successor shifted to every offset of the shape. Otherwise each cell adds up, column by column,
+	// the popcount of the plane bits its neighbourhood covers.
+	// BuildBitplanes runs over every column first, then BitplaneStep reads the planes of the neighbouring columns.
+	void BuildBitplanes(int xFirst, int xLast)
+	{
+		for (int x = xFirst; x < xLast; x++)
 		{
-			for (int y = 0; y < textureHeight; y++)
+			for (int state = 0; state <= colorNumber; state++)
+				std::fill(Plane(state, x), Plane(state, x) + planeWords - 2, 0);
+
+			const Cell* column = stateGrid.column(x);
+			uint64_t* planes = Plane(0, x);
+			for (int y = 0; y < rows; y++)      // the halo of a clamped grid fills a plane of its own, nobody reads it
+				planes[(size_t)column[y] * columns * planeWords + (y >> 6)] |= uint64_t(1) << (y & 63);
+		}
+	}
+
+	void BitplaneStep(const Tile& tile, Scratch& buffers)
+	{
+		int successorIndex;
+		if (threshold == 1)
+		{
+			for (int x = tile.xFirst; x < tile.xLast; x++)
 			{
-				if (x < margin || y < margin || x >= (textureWidth - margin) || y >= (textureHeight - margin))
+				for (int word = tile.yFirst >> 6; word <= (tile.yLast - 1) >> 6; word++)
 				{
-					colorIndex = -2;
-					color = { 0, 0, 0 }; // color of the semitransparent part of the frame
+					uint64_t inner = ~uint64_t(0);   // the bits of this word that are cells of the tile
+					if (word * 64 < tile.yFirst) inner &= ~uint64_t(0) << (tile.yFirst - word * 64);
+					if (word * 64 + 64 > tile.yLast) inner &= ~uint64_t(0) >> (word * 64 + 64 - tile.yLast);
+
+					for (int state = 0; state < colorNumber; state++)
+					{
+						uint64_t cells = Plane(state == 0 ? colorNumber - 1 : state - 1, x)[word] & inner;   // the cells whose successor is state
+						if (!cells) continue;
+
+						uint64_t found = 0;
+						for (int i = -range; i <= range; i++)
+						{
+							const uint64_t* plane = Plane(state, x + i);
+							for (int j = neighbourhood.column_first(i); j <= neighbourhood.column_last(i); j++)
+								found |= ShiftedWord(plane, word, j);
+						}
+
+						for (cells &= found; cells; cells &= cells - 1)
+							Transition(buffers, x, word * 64 + PopCount((cells & (0 - cells)) - 1), state);  // popcount below the lowest set bit is its index
+					}
 				}
-				else if (x < xStartIndex || y < yStartIndex || x >= xEndIndex || y >= yEndIndex)
+			}
+			return;
+		}
+
+		for (int x = tile.xFirst; x < tile.xLast; x++)
+		{
+			const Cell* column = stateGrid.column(x);
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+			{
+				successorIndex = successorTable[column[y]];
+
+				int count = 0;
+				for (int i = -range; i <= range && count < threshold; i++)
 				{
-					colorIndex = -1;
-					color = { 255, 255, 255 };    // white color of the frame
+					int first = y + neighbourhood.column_first(i);
+					int length = neighbourhood.column_last(i) - neighbourhood.column_first(i) + 1;
+					const uint64_t* plane = Plane(successorIndex, x + i);
+					uint64_t bits = plane[first >> 6] >> (first & 63);
+					if (first & 63) bits |= plane[(first >> 6) + 1] << (64 - (first & 63));
+					count += PopCount(bits & ((uint64_t(1) << length) - 1));
+				}
+
+				if (count >= threshold)
+					Transition(buffers, x, y, successorIndex);
+			}
+		}
+	}
+
+	// Same result as EarlyExitStep, with one column of cells tested per kernel call. The kernel walks the
+	// neighbourhood offsets for a whole vector of cells at once and stops once every lane is decided.
+	void SimdStep(const Tile& tile, const GridView& cells, Scratch& buffers)
+	{
+#if BYTE_CELLS
+		std::vector<int8_t>& simdSuccessors = buffers.simdSuccessors;
+		for (int x = tile.xFirst; x < tile.xLast; x++)
+		{
+			simdColumn(cells.cell(x, tile.yFirst), tile.yLast - tile.yFirst, neighbourhood.offsets().data(),
+				(int)neighbourhood.offsets().size(), colorNumber, threshold, simdSuccessors.data());
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+				if (simdSuccessors[y - tile.yFirst] >= 0)
+					Transition(buffers, x, y, simdSuccessors[y - tile.yFirst]);
+		}
+#endif
+	}
+
+	// Same result as EarlyExitStep, with the SIMD kernels reading packedGrid. A tile starts in the low nibble
+	// of a byte, so its row y is nibble (y - yFirst) & 1 of byte (y - yFirst) / 2 from there.
+	void PackedStep(const Tile& tile, Scratch& buffers)
+	{
+		const int bytes = (tile.yLast - tile.yFirst + 1) >> 1;
+		for (int x = tile.xFirst; x < tile.xLast; x++)
+		{
+			packedColumn(packedGrid.pairs(x, tile.yFirst), bytes, packedGrid.stride(), neighbourhood.column_firsts(),
+				neighbourhood.column_lasts(), range, colorNumber, threshold, buffers.lowSuccessors.data(), buffers.highSuccessors.data());
+			for (int y = tile.yFirst; y < tile.yLast; y++)
+			{
+				int successor = ((y - tile.yFirst) & 1) ? buffers.highSuccessors[(y - tile.yFirst) >> 1] : buffers.lowSuccessors[(y - tile.yFirst) >> 1];
+				if (successor >= 0)
+					Transition(buffers, x, y, successor);
+			}
+		}
+	}
+
+	uint64_t* Plane(int state, int x)
+	{
+		return &bitplanes[((size_t)state * columns + x) * planeWords + 1];    // + 1 skips the zero word in front
+	}
+
+	// bit b of the result is bit (word * 64 + b + shift) of the plane, for -64 < shift < 64
+	static uint64_t ShiftedWord(const uint64_t* plane, int word, int shift)
+	{
+		if (shift > 0) return (plane[word] >> shift) | (plane[word + 1] << (64 - shift));
+		if (shift < 0) return (plane[word] << -shift) | (plane[word - 1] >> (64 + shift));
+		return plane[word];
+	}
+
+	void Transition(Scratch& buffers, int x, int y, int successorIndex)
+	{
+		buffers.changes.push_back({ x, y, successorIndex });   // applied once the whole generation has been evaluated
+	}
+
+	// The lists are applied in parallel. The cells of a tile are only ever listed by the worker that took it,
+	// and on a packed grid no two tiles share a byte, see PackedGrid.
+	void ApplyChanges(const std::vector<Change>& changes)
+	{
+		if (engine == PACKED)
+		{
+			for (const Change& change : changes)
+				packedGrid.set(change.x, change.y, change.state);
+			return;
+		}
+		for (const Change& change : changes)
+			stateGrid.column(change.x)[change.y] = change.state;
+	}
+
+	bool NeighbourhoodAlgorithm(const Cell* cell, int successorIndex)
+	{
+		int count = 0;
+
+		for (int offset : neighbourhood.offsets())
+		{                                           // check every cell of the neighbourhood shape
+			if (cell[offset] == successorIndex) count++; // increase the total count of successor neighbours
+			if (count >= threshold) return true;    // return true if the count surpasses the threshold
+		}
+		return false;
+	}
+
+	void SetupEngine()
+	{
+		struct SpecialisedKernel {
+			int range;
+			int threshold;
+			bool moore;
+			void (CCA::*step)(const Tile&, const GridView&, Scratch&);
+		};
+		static const SpecialisedKernel specialisedKernels[] = {    // well known rules, plus this file's default and that of the former cca2DinClassArrays.cpp
+			{ 1, 1, false, &CCA::SpecialisedStep<1, 1, false> },   // CCA, Diamond Spirals, R1/T1/C12
+			{ 1, 2, true, &CCA::SpecialisedStep<1, 2, true> },     // Imperfect
+			{ 1, 3, true, &CCA::SpecialisedStep<1, 3, true> },     // 313, Perfect Spirals
+			{ 2, 2, false, &CCA::SpecialisedStep<2, 2, false> },   // Squarish Spirals
+			{ 2, 3, false, &CCA::SpecialisedStep<2, 3, false> },   // Maps
+			{ 2, 5, false, &CCA::SpecialisedStep<2, 5, false> },   // Cubism
+			{ 2, 5, true, &CCA::SpecialisedStep<2, 5, true> },     // Turbulent Phase
+			{ 2, 9, true, &CCA::SpecialisedStep<2, 9, true> },     // Fossil Debris
+			{ 2, 10, true, &CCA::SpecialisedStep<2, 10, true> },   // Lava Lamp
+			{ 2, 11, true, &CCA::SpecialisedStep<2, 11, true> },   // Bootstrap
+			{ 3, 4, false, &CCA::SpecialisedStep<3, 4, false> },   // Stripes
+			{ 3, 5, true, &CCA::SpecialisedStep<3, 5, true> },     // Cyclic Spirals
+			{ 3, 10, false, &CCA::SpecialisedStep<3, 10, false> }, // Amoeba
+			{ 4, 4, false, &CCA::SpecialisedStep<4, 4, false> },   // Fuzz
+			{ 5, 23, false, &CCA::SpecialisedStep<5, 23, false> }, // Black vs White
+			{ 6, 7, false, &CCA::SpecialisedStep<6, 7, false> },   // R6/T7/C18
+		};
+
+		specialisedStep = nullptr;
+		for (const SpecialisedKernel& kernel : specialisedKernels)
+			if (kernel.range == range && kernel.threshold == threshold && (kernel.moore ? MOORE : VON_NEUMANN) == shape)
+				specialisedStep = kernel.step;
+
+		if (engine == AUTO)
+		{
+			if (BYTE_CELLS && threshold <= 255 && DetectSimdLevel() != SIMD_NONE) engine = SIMD;
+			else if (colorNumber <= PackedStates() && threshold <= 255 && DetectSimdLevel() != SIMD_NONE) engine = PACKED;   // int cells, the nibbles get them to SIMD
+			else if (threshold == 1 && range <= 31) engine = BITPLANE;
+			else if (range < 2) engine = EARLY_EXIT;    // the scan is already short, the bookkeeping would cost more
+			else if (shape == MOORE) engine = SLIDING_WINDOW;
+			else if (shape == VON_NEUMANN) engine = DIAMOND;
+			else engine = EARLY_EXIT;
+		}
+		if (engine == BITPLANE && range > 31)
+		{
+			std::cout << "The bitplane engine supports ranges up to 31, falling back to early exit" << std::endl;
+			engine = EARLY_EXIT;
+		}
+		if (engine == SIMD)
+		{
+			int level = DetectSimdLevel();
+#if defined(CCA_X86)
+			if (level == SIMD_AVX512) simdColumn = SimdColumnAVX512;
+			else if (level == SIMD_AVX2) simdColumn = SimdColumnAVX2;
+			else if (level == SIMD_SSE2) simdColumn = SimdColumnSSE2;
+#endif
+			std::cout << "SIMD level: " << SimdLevelName(level) << std::endl;
+
+			if (!BYTE_CELLS || level == SIMD_NONE || threshold > 255)
+			{
+				std::cout << "The SIMD engine needs BYTE_CELLS, SSE2 and a threshold up to 255, falling back to early exit" << std::endl;
+				engine = EARLY_EXIT;
+			}
+		}
+		if (engine == PACKED)
+		{
+			int level = DetectSimdLevel();
+#if defined(CCA_X86)
+			if (level == SIMD_AVX512) packedColumn = PackedColumnAVX512;
+			else if (level == SIMD_AVX2) packedColumn = PackedColumnAVX2;
+			else if (level == SIMD_SSE2) packedColumn = PackedColumnSSE2;
+#endif
+			std::cout << "SIMD level: " << SimdLevelName(level) << std::endl;
+
+			if (level == SIMD_NONE || threshold > 255 || colorNumber > PackedStates() || TILE_SIZE % 2)
+			{
+				std::cout << "The packed engine needs SSE2, a threshold up to 255, at most " << PackedStates() << " states and an even TILE_SIZE, falling back to early exit" << std::endl;
+				engine = EARLY_EXIT;
+			}
+		}
+		if (engine == SPECIALISED && !specialisedStep)
+		{
+			std::cout << "No specialised kernel for this rule, falling back to early exit" << std::endl;
+			engine = EARLY_EXIT;
+		}
+		if (engine == SLIDING_WINDOW && shape != MOORE)
+		{
+			std::cout << "The sliding window engine only supports Moore, falling back to early exit" << std::endl;
+			engine = EARLY_EXIT;
+		}
+		if (engine == DIAMOND && shape != VON_NEUMANN)
+		{
+			std::cout << "The diamond engine only supports vonNeumann, falling back to early exit" << std::endl;
+			engine = EARLY_EXIT;
+		}
+		if (engine == DIAMOND && 2 * (size_t)rotatedRows * rotatedColumns * (sizeof(Cell) + sizeof(uint16_t) * pool.size()) > (size_t(1) << 30))
+		{                                                   // the rotated grid, plus summed-area tables for each worker
+			std::cout << "The diamond tables would not fit in memory for a grid this big, falling back to early exit" << std::endl;
+			engine = EARLY_EXIT;
+		}
+
+		scratch.assign(pool.size(), {});
+		for (Scratch& buffers : scratch)
+		{
+			if (engine == SLIDING_WINDOW)
+			{
+				buffers.stripCounts.assign(rows * (colorNumber + 1), 0);
+				buffers.windowCounts.assign(colorNumber + 1, 0);
+			}
+			if (engine == SIMD)
+				buffers.simdSuccessors.assign(TILE_SIZE + 64, -1);
+			if (engine == PACKED)
+			{
+				buffers.lowSuccessors.assign(TILE_SIZE / 2 + 1 + 64, -1);
+				buffers.highSuccessors.assign(TILE_SIZE / 2 + 1 + 64, -1);
+			}
+			if (engine == DIAMOND)
+			{
+				buffers.diamondSums.assign(2 * (size_t)rotatedRows * rotatedColumns, 0);      // the first row and column stay 0
+				buffers.cellsBySuccessor.assign(colorNumber, {});
+			}
+		}
+		if (engine == BITPLANE)
+			bitplanes.assign((size_t)(colorNumber + 1) * columns * planeWords, 0);
+		if (engine == DIAMOND)
+			rotatedStates.assign(2 * (size_t)rotatedRows * rotatedColumns, -3);   // -3 marks the corners no cell maps to
+	}
+
+	int PackedStates() const    // how many states a nibble can hold next to the halo value of a clamped grid
+	{
+		return boundary == CLAMPED ? 15 : 16;
+	}
+
+	// Both tables have an entry for the halo value of a clamped grid too, which is its own successor and is never drawn
+	void SetupStateTables()
+	{
+		successorTable.assign(colorNumber + 1, colorNumber);
+		pixelTable.assign(colorNumber + 1, olc::BLANK.n);
+		for (int state = 0; state < colorNumber; state++)
+		{
+			successorTable[state] = state == colorNumber - 1 ? 0 : state + 1;
+			pixelTable[state] = olc::Pixel(colorPalette[state].red, colorPalette[state].green, colorPalette[state].blue).n;
+		}
+	}
+
+	void SetupThreads()
+	{
+		if (threadCount <= 0) threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+		pool.start(threadCount);
+		std::cout << "Threads: " << threadCount << std::endl;
+	}
+
+	void SetupGrid()
+	{
+		pad = range;
+		columns = gridWidth + 2 * pad;
+		rows = gridHeight + 2 * pad;
+		xStartIndex = pad;
+		xEndIndex = pad + gridWidth;
+		yStartIndex = pad;
+		yEndIndex = pad + gridHeight;
+		if (boundary != CLAMPED && (gridWidth < range || gridHeight < range))
+		{
+			std::cout << "Wrapping and mirroring need a grid at least as big as the range, falling back to clamped edges" << std::endl;
+			boundary = CLAMPED;
+		}
+		std::cout << "Grid: " << gridWidth << " x " << gridHeight;
+		if (boundary == TOROIDAL) std::cout << ", toroidal" << std::endl;
+		else if (boundary == MIRROR) std::cout << ", mirrored" << std::endl;
+		else std::cout << ", clamped" << std::endl;
+
+		bandCount = std::min(threadCount, columns);
+
+		rotatedShift = rows + (rows & 1);
+		rotatedRows = (columns + rows) / 2 + 2;
+		rotatedColumns = (columns + rotatedShift) / 2 + 2;
+		planeWords = (rows + 63) / 64 + 2;
+
+		tiles.clear();
+		for (int x = xStartIndex; x < xEndIndex; x += TILE_SIZE)
+			for (int y = yStartIndex; y < yEndIndex; y += TILE_SIZE)
+				tiles.push_back({ x, std::min(x + TILE_SIZE, xEndIndex), y, std::min(y + TILE_SIZE, yEndIndex) });
+		tilesPerColumn = (gridHeight + TILE_SIZE - 1) / TILE_SIZE;
+
+		// Along one axis, the tiles holding a cell within range of [first, last): every position of the span
+		// widened by the range is taken through the boundary, the way the halo wraps or mirrors it, so the
+		// tiles are found however narrow the last tile is compared to the range
+		auto tilesAlong = [&](int first, int last, int size) {
+			std::vector<int> found;
+			for (int u = first - range; u < last + range; u++)
+			{
+				int v = u;
+				if (boundary == TOROIDAL) v = (u % size + size) % size;
+				else if (boundary == MIRROR) v = u < 0 ? -u - 1 : (u >= size ? 2 * size - u - 1 : u);
+				if (v >= 0 && v < size) found.push_back(v / TILE_SIZE);     // clamped: nothing past the edges
+			}
+			std::sort(found.begin(), found.end());
+			found.erase(std::unique(found.begin(), found.end()), found.end());
+			return found;
+		};
+
+		const int tileColumns = (int)tiles.size() / tilesPerColumn;
+		std::vector<std::vector<int>> columnReach(tileColumns), rowReach(tilesPerColumn);
+		for (int i = 0; i < tileColumns; i++)
+			columnReach[i] = tilesAlong(i * TILE_SIZE, std::min((i + 1) * TILE_SIZE, gridWidth), gridWidth);
+		for (int j = 0; j < tilesPerColumn; j++)
+			rowReach[j] = tilesAlong(j * TILE_SIZE, std::min((j + 1) * TILE_SIZE, gridHeight), gridHeight);
+
+		tileNeighbours.assign(tiles.size(), {});
+		for (int t = 0; t < (int)tiles.size(); t++)
+			for (int column : columnReach[t / tilesPerColumn])
+				for (int row : rowReach[t % tilesPerColumn])
+					tileNeighbours[t].push_back(column * tilesPerColumn + row);
+		tileChanged.assign(tiles.size(), true);     // the first generation evaluates everything
+		tileActive.assign(tiles.size(), true);
+	}
+
+	// The grid is allocated untouched and then filled with the halo value by every worker at once,
+	// so the pages are faulted in in parallel, each near the thread that filled it. The packed engine
+	// keeps the grid as nibbles and needs no CellGrid at all, its stride stays 0 as its kernels take the
+	// shape column by column rather than as offsets. A wrapped or mirrored halo of 16 states gets 0 here,
+	// RefreshHalo overwrites it before it is read.
+	void AllocateGrid()
+	{
+		if (engine == PACKED)
+		{
+			packedGrid.allocate(columns, rows, yStartIndex, range, HUGE_PAGES);
+			pool.run(bandCount, [&](int band, int worker) { packedGrid.fill_columns(BandStart(band, 0, columns), BandStart(band + 1, 0, columns), colorNumber); });
+			return;
+		}
+		stateGrid.allocate(columns, rows, HUGE_PAGES);
+		stride = stateGrid.stride();
+		pool.run(bandCount, [&](int band, int worker) { stateGrid.fill_columns(BandStart(band, 0, columns), BandStart(band + 1, 0, columns), colorNumber); });
+	}
+
+	void RefreshHalo()
+	{
+		if (engine == PACKED) RefreshHalo(packedGrid);
+		else RefreshHalo(stateGrid);
+	}
+
+	// Copies the cells the halo mirrors or wraps to. The rows go first, then whole columns,
+	// which carries the corners along. A clamped halo keeps the colorNumber it was filled with.
+	template <class Grid>
+	void RefreshHalo(Grid& grid)
+	{
+		if (boundary == CLAMPED) return;
+
+		for (int x = xStartIndex; x < xEndIndex; x++)
+		{
+			for (int k = 1; k <= pad; k++)
+			{
+				if (boundary == TOROIDAL)
+				{
+					grid.copy_cell(x, yEndIndex - k, x, yStartIndex - k);
+					grid.copy_cell(x, yStartIndex + k - 1, x, yEndIndex + k - 1);
 				}
 				else
 				{
-					colorIndex = rand() % colorNumber;  // everything else set randomly
-					color = colorPalette[colorIndex];
+					grid.copy_cell(x, yStartIndex + k - 1, x, yStartIndex - k);
+					grid.copy_cell(x, yEndIndex - k, x, yEndIndex + k - 1);
 				}
-                stateArrays.set_first(x, y, colorIndex);
+			}
+		}
+		for (int k = 1; k <= pad; k++)
+		{
+			if (boundary == TOROIDAL)
+			{
+				grid.copy_column(xEndIndex - k, xStartIndex - k);
+				grid.copy_column(xStartIndex + k - 1, xEndIndex + k - 1);
+			}
+			else
+			{
+				grid.copy_column(xStartIndex + k - 1, xStartIndex - k);
+				grid.copy_column(xEndIndex - k, xEndIndex + k - 1);
+			}
+		}
+	}
+
+	// Writes the part of the grid the window shows straight into layer 0, with the pixels taken from pixelTable.
+	// This skips Draw and its pixel mode and bounds checks for every cell, and the rows are split into bands
+	// so the workers draw in parallel.
+	// The grid runs down the columns and the sprite along the rows, so the window is drawn in square blocks:
+	// each sprite row of a block is written in order while the block's grid columns stay in L1, instead of
+	// a whole window row touching a line of every column before the first one is used again.
+	void PresentGrid()
+	{
+		if (!GetDrawTarget()) return;   // not constructed, as in the benchmarks
+		const int visibleRows = std::min(INNER_SIZE, gridHeight - viewY);
+		const GenerationView grid = LatestGeneration();     // one task per kind of view, each with a loop of its own
+		if (grid.packed.data) pool.run(bandCount, [&](int band, int worker) { PresentRows(grid.packed, BandStart(band, 0, visibleRows), BandStart(band + 1, 0, visibleRows)); });
+		else pool.run(bandCount, [&](int band, int worker) { PresentRows(grid.cells, BandStart(band, 0, visibleRows), BandStart(band + 1, 0, visibleRows)); });
+		MarkChangedTiles();
+	}
+
+	// Only what changed is sent to the texture: each column of tiles marks layer 0 dirty from its first to its
+	// last changed tile, inside the window. The rest of the window holds the same pixels as the last frame.
+	void MarkChangedTiles()
+	{
+		olc::Sprite* target = GetDrawTarget();
+		const int tileColumns = (int)tiles.size() / tilesPerColumn;
+		const int xLast = viewX + std::min(INNER_SIZE, gridWidth - viewX);
+		const int yLast = viewY + std::min(INNER_SIZE, gridHeight - viewY);
+		for (int column = 0; column < tileColumns; column++)
+		{
+			int first = -1, last = -1;
+			for (int row = 0; row < tilesPerColumn; row++)
+				if (tileChanged[column * tilesPerColumn + row])
+				{
+					if (first < 0) first = row;
+					last = row;
+				}
+			if (first < 0) continue;
+
+			const Tile& top = tiles[column * tilesPerColumn + first];
+			const Tile& bottom = tiles[column * tilesPerColumn + last];
+			const int x0 = std::max(top.xFirst - xStartIndex, viewX), x1 = std::min(top.xLast - xStartIndex, xLast);
+			const int y0 = std::max(top.yFirst - yStartIndex, viewY), y1 = std::min(bottom.yLast - yStartIndex, yLast);
+			if (x0 < x1 && y0 < y1)
+				target->MarkDirty({ screenStart + x0 - viewX, screenStart + y0 - viewY }, { x1 - x0, y1 - y0 });
+		}
+	}
+
+	template <class View>
+	void PresentRows(const View& grid, int first, int last)
+	{
+		const int block = 64;   // cells per side of the blocks
+		const int visibleColumns = std::min(INNER_SIZE, gridWidth - viewX);
+		const int targetWidth = GetDrawTargetWidth();
+		olc::Pixel* target = GetDrawTarget()->GetData() + (size_t)screenStart * targetWidth + screenStart;
+		for (int yBlock = first; yBlock < last; yBlock += block)
+		{
+			const int yEnd = std::min(yBlock + block, last);
+			for (int xBlock = 0; xBlock < visibleColumns; xBlock += block)
+			{
+				const int xEnd = std::min(xBlock + block, visibleColumns);
+				for (int y = yBlock; y < yEnd; y++)
+					PresentRow(grid, viewY + y, xBlock, xEnd, target + (size_t)y * targetWidth);
+			}
+		}
+	}
+
+	// Pixels [xFirst, xLast) of row, from grid row y and the columns from viewX on. The stride is read into a local
+	// first: the stores to row could alias the view, and it would be loaded again for every pixel.
+	void PresentRow(const GridView& grid, int y, int xFirst, int xLast, olc::Pixel* row) const
+	{
+		const uint32_t* pixels = pixelTable.data();
+		const Cell* cells = grid.cell(viewX, y);
+		const size_t stride = grid.stride;
+		for (int x = xFirst; x < xLast; x++)
+			row[x].n = pixels[cells[x * stride]];
+	}
+
+	void PresentRow(const PackedView& grid, int y, int xFirst, int xLast, olc::Pixel* row) const
+	{
+		const uint32_t* pixels = pixelTable.data();
+		const uint8_t* pairs = grid.pairs(viewX, y);
+		const int shift = grid.shift(y);
+		const size_t stride = grid.stride;
+		for (int x = xFirst; x < xLast; x++)
+			row[x].n = pixels[(pairs[x * stride] >> shift) & 0x0F];
+	}
+
+	// The frame never changes, so it goes on a layer below layer 0 that is uploaded once. Layer 0 is cleared
+	// to transparent and then only ever receives cells, the frame shows through around them.
+	void DrawFrame()
+	{
+		if (GetLayers().empty()) return;    // not constructed: there is no window to draw on
+		frameLayer = CreateLayer();
+		SetDrawTarget(frameLayer);
+
+		Color color;
+		for (int x = 0; x < textureWidth; x++)
+		{
+			for (int y = 0; y < textureHeight; y++)
+			{
+				if (x < margin || y < margin || x >= (textureWidth - margin) || y >= (textureHeight - margin))
+					color = { 0, 0, 0 }; // color of the semitransparent part of the frame
+				else if (x < screenStart || y < screenStart || x >= textureWidth - screenStart || y >= textureHeight - screenStart)
+					color = { 255, 255, 255 };    // white color of the frame
+				else
+					color = { 0, 0, 0 };    // left black where the grid is smaller than the window
 				Draw(x, y, olc::Pixel(color.red, color.green, color.blue));
 			}
 		}
+		EnableLayer(frameLayer, true);
+		SetDrawTarget(nullptr);
+		Clear(olc::BLANK);
+	}
+
+	void RandomizeTexture()
+	{
+        // seed the random number generators with the current time
+        time_t  timev;
+        time(&timev);
+
+		pool.run(bandCount, [&](int band, int worker) {    // one generator per band, so big grids fill in parallel
+			std::minstd_rand generator((unsigned)timev + band);
+			int colorIndex;
+			for (int x = BandStart(band, xStartIndex, xEndIndex); x < BandStart(band + 1, xStartIndex, xEndIndex); x++)
+			{
+				for (int y = yStartIndex; y < yEndIndex; y++)
+				{
+					colorIndex = generator() % colorNumber;  // every cell of the grid set randomly, RefreshHalo fills the halo
+					if (engine == PACKED) packedGrid.set(x, y, colorIndex);
+					else stateGrid.set(x, y, colorIndex);
+				}
+			}
+		});
 	}
 
     void SetupColors()  // i wanted each number of states to have a specific color palette...
@@ -445,17 +2032,23 @@ private:
 
 int main()
 {
+    if (BENCHMARK)
+    {
+        CCA::PresentBenchmark();
+        return 0;
+    }
+
     //* USE HEAP MEMORY
 	CCA *app;
     app = new CCA();
-	if (app->Construct(TOT_SIZE, TOT_SIZE, 1, 1))
+	if (app->Construct(TOT_SIZE, TOT_SIZE, 1, 1, false, false, false, HEADLESS > 0, HEADLESS))
 		app->Start();
     delete(app);
     //*/
 
     /* USE STACK MEMORY
     CCA app;
-    if (app.Construct(TOT_SIZE, TOT_SIZE, 1, 1))
+    if (app.Construct(TOT_SIZE, TOT_SIZE, 1, 1, false, false, false, HEADLESS > 0, HEADLESS))
         app.Start();
     //*/
 
@@ -539,6 +539,22 @@ namespace olc
 		Mode modeSample = Mode::NORMAL;
 
 		static std::unique_ptr<olc::ImageLoader> loader;
+
+	public:
+		// Regions written since the renderer last uploaded the sprite, so a layer only sends those.
+		// SetPixel records its own writes, code writing through GetData() calls MarkDirty.
+		// Decal::Update always sends the whole sprite.
+		struct Rect { olc::vi2d pos; olc::vi2d size; };
+		void MarkDirty();
+		void MarkDirty(const olc::vi2d& pos, const olc::vi2d& size);
+		const std::vector<Rect>& GetDirtyRects();
+		void ClearDirty();
+
+	private:
+		static const size_t nMaxDirtyRects = 32; // past this many, the regions merge into their bounding box
+		std::vector<Rect> vDirtyRects;
+		olc::vi2d vPixelsMin = { INT32_MAX, INT32_MAX }; // bounding box of the SetPixel writes
+		olc::vi2d vPixelsMax = { -1, -1 };
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -661,8 +677,10 @@ namespace olc
 		PixelGameEngine();
 		virtual ~PixelGameEngine();
 	public:
+		// headless swaps in a platform and renderer that open no window and keep the layers in memory,
+		// max_frames stops the engine after that many frames (0 runs until OnUserUpdate returns false)
 		olc::rcode Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h,
-			bool full_screen = false, bool vsync = false, bool cohesion = false);
+			bool full_screen = false, bool vsync = false, bool cohesion = false, bool headless = false, uint32_t max_frames = 0);
 		olc::rcode Start();
 
 	public: // User Override Interfaces
@@ -851,6 +869,8 @@ namespace olc
 		uint8_t		nTargetLayer = 0;
 		uint32_t	nLastFPS = 0;
 		bool        bPixelCohesion = false;
+		uint32_t	nFrameLimit = 0;
+		uint32_t	nFramesRun = 0;
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
 		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
 
@@ -870,6 +890,7 @@ namespace olc
 		// At the very end of this file, chooses which
 		// components to compile
 		void        olc_ConfigureSystem();
+		void        olc_ConfigureHeadless();
 
 		// If anything sets this flag to false, the engine
 		// "should" shut down gracefully
@@ -992,6 +1013,7 @@ namespace olc
 		pColData = new Pixel[width * height];
 		for (int32_t i = 0; i < width * height; i++)
 			pColData[i] = Pixel();
+		MarkDirty();
 	}
 
 	Sprite::~Sprite()
@@ -1009,6 +1031,7 @@ namespace olc
 			is.read((char*)&height, sizeof(int32_t));
 			pColData = new Pixel[width * height];
 			is.read((char*)pColData, (size_t)width * (size_t)height * sizeof(uint32_t));
+			MarkDirty();
 		};
 
 		// These are essentially Memory Surfaces represented by olc::Sprite
@@ -1082,6 +1105,8 @@ namespace olc
 		if (x >= 0 && x < width && y >= 0 && y < height)
 		{
 			pColData[y * width + x] = p;
+			vPixelsMin = { std::min(vPixelsMin.x, x), std::min(vPixelsMin.y, y) };
+			vPixelsMax = { std::max(vPixelsMax.x, x), std::max(vPixelsMax.y, y) };
 			return true;
 		}
 		else
@@ -1120,11 +1145,52 @@ namespace olc
 	Pixel* Sprite::GetData()
 	{ return pColData; }
 
+	void Sprite::MarkDirty()
+	{ MarkDirty({ 0, 0 }, { width, height }); }
+
+	void Sprite::MarkDirty(const olc::vi2d& pos, const olc::vi2d& size)
+	{
+		olc::vi2d first = { std::max(pos.x, 0), std::max(pos.y, 0) };
+		olc::vi2d last = { std::min(pos.x + size.x, width), std::min(pos.y + size.y, height) };
+		if (first.x >= last.x || first.y >= last.y) return;
+
+		if (vDirtyRects.size() == nMaxDirtyRects)
+		{
+			for (const auto& rect : vDirtyRects)
+			{
+				first = { std::min(first.x, rect.pos.x), std::min(first.y, rect.pos.y) };
+				last = { std::max(last.x, rect.pos.x + rect.size.x), std::max(last.y, rect.pos.y + rect.size.y) };
+			}
+			vDirtyRects.clear();
+		}
+		vDirtyRects.push_back({ first, last - first });
+	}
+
+	const std::vector<Sprite::Rect>& Sprite::GetDirtyRects()
+	{
+		if (vPixelsMax.x >= 0)
+		{
+			MarkDirty(vPixelsMin, vPixelsMax - vPixelsMin + olc::vi2d(1, 1));
+			vPixelsMin = { INT32_MAX, INT32_MAX };
+			vPixelsMax = { -1, -1 };
+		}
+		return vDirtyRects;
+	}
+
+	void Sprite::ClearDirty()
+	{
+		vDirtyRects.clear();
+		vPixelsMin = { INT32_MAX, INT32_MAX };
+		vPixelsMax = { -1, -1 };
+	}
+
 
 	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
 	{
 		UNUSED(pack);
-		return loader->LoadImageResource(this, sImageFile, pack);
+		olc::rcode result = loader->LoadImageResource(this, sImageFile, pack);
+		MarkDirty();
+		return result;
 	}
 
 	olc::Sprite* Sprite::Duplicate()
@@ -1160,6 +1226,7 @@ namespace olc
 	{
 		if (sprite == nullptr) return;
 		vUVScale = { 1.0f / float(sprite->width), 1.0f / float(sprite->height) };
+		sprite->MarkDirty(); // an explicit request, and the sprite may back other textures or have been written through GetData()
 		renderer->ApplyTexture(id);
 		renderer->UpdateTexture(id, sprite);
 	}
@@ -1399,9 +1466,11 @@ namespace olc
 	{}
 
 
-	olc::rcode PixelGameEngine::Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h, bool full_screen, bool vsync, bool cohesion)
+	olc::rcode PixelGameEngine::Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h, bool full_screen, bool vsync, bool cohesion, bool headless, uint32_t max_frames)
 	{
 		bPixelCohesion = cohesion;
+		nFrameLimit = max_frames;
+		if (headless) olc_ConfigureHeadless();
 		vScreenSize = { screen_w, screen_h };
 		vInvScreenSize = { 1.0f / float(screen_w), 1.0f / float(screen_h) };
 		vPixelSize = { pixel_w, pixel_h };
@@ -1825,6 +1894,7 @@ namespace olc
 		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
 		Pixel* m = GetDrawTarget()->GetData();
 		for (int i = 0; i < pixels; i++) m[i] = p;
+		GetDrawTarget()->MarkDirty();
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -2598,6 +2668,8 @@ namespace olc
 			// Handle Frame Update
 		if (!OnUserUpdate(fElapsedTime))
 			bAtomActive = false;
+		if (nFrameLimit > 0 && ++nFramesRun >= nFrameLimit)
+			bAtomActive = false;
 
 		// Display Frame
 		renderer->UpdateViewport(vViewPos, vViewSize);
@@ -2746,6 +2818,23 @@ namespace olc
 	#include <OpenGL/glu.h>
 #endif
 
+// Pixel buffer objects (OpenGL 1.5 or GL_ARB_pixel_buffer_object), loaded at run time when the driver has them
+#if !defined(GL_PIXEL_UNPACK_BUFFER)
+	#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#if !defined(GL_STREAM_DRAW)
+	#define GL_STREAM_DRAW 0x88E0
+#endif
+#if !defined(GL_WRITE_ONLY)
+	#define GL_WRITE_ONLY 0x88B9
+#endif
+typedef void(APIENTRY glGenBuffers_t)(GLsizei n, GLuint* buffers);
+typedef void(APIENTRY glDeleteBuffers_t)(GLsizei n, const GLuint* buffers);
+typedef void(APIENTRY glBindBuffer_t)(GLenum target, GLuint buffer);
+typedef void(APIENTRY glBufferData_t)(GLenum target, ptrdiff_t size, const GLvoid* data, GLenum usage);
+typedef GLvoid*(APIENTRY glMapBuffer_t)(GLenum target, GLenum access);
+typedef GLboolean(APIENTRY glUnmapBuffer_t)(GLenum target);
+
 namespace olc
 {
 	class Renderer_OGL10 : public olc::Renderer
@@ -2759,6 +2848,20 @@ namespace olc
 #endif
 
 		bool bSync = false;
+		std::map<uint32_t, olc::vi2d> mapTextureSize; // size each texture was allocated at, zero before its first upload
+
+		// Textures updated after their first upload stream through a pixel buffer of their own: its storage is
+		// orphaned before every map, so the dirty regions go into fresh memory while the driver may still be
+		// reading the previous frame out of the old one, and glTexSubImage2D returns without waiting for the
+		// transfer. Without the extension they are sent directly.
+		std::map<uint32_t, GLuint> mapPixelBuffers;
+		bool bPixelBuffers = false;
+		glGenBuffers_t* glGenBuffers = nullptr;
+		glDeleteBuffers_t* glDeleteBuffers = nullptr;
+		glBindBuffer_t* glBindBuffer = nullptr;
+		glBufferData_t* glBufferData = nullptr;
+		glMapBuffer_t* glMapBuffer = nullptr;
+		glUnmapBuffer_t* glUnmapBuffer = nullptr;
 
 #if defined(__linux__) || defined(__FreeBSD__)
 		X11::Display* olc_Display = nullptr;
@@ -2854,10 +2957,49 @@ namespace olc
 #else
 			glEnable(GL_TEXTURE_2D); // Turn on texturing
 			glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+			LoadPixelBuffers();
 #endif
 			return olc::rcode::OK;
 		}
 
+		void LoadPixelBuffers()
+		{
+#if defined(_WIN32) || defined(__linux__) || defined(__FreeBSD__)
+			auto GetProc = [](const std::string& name)
+			{
+#if defined(_WIN32)
+				void* proc = (void*)wglGetProcAddress(name.c_str());
+				if (proc == nullptr) proc = (void*)wglGetProcAddress((name + "ARB").c_str());
+#else
+				void* proc = (void*)X11::glXGetProcAddress((unsigned char*)name.c_str());
+				if (proc == nullptr) proc = (void*)X11::glXGetProcAddress((unsigned char*)(name + "ARB").c_str());
+#endif
+				return proc;
+			};
+
+			const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+			if (extensions == nullptr || (std::strstr(extensions, "GL_ARB_pixel_buffer_object") == nullptr && std::strstr(extensions, "GL_EXT_pixel_buffer_object") == nullptr))
+				return;
+
+#if !defined(PGE_FORCE_PIXEL_BUFFERS)
+			// A software rasterizer has no transfer to overlap, the buffers would only add a copy.
+			// Define PGE_FORCE_PIXEL_BUFFERS to use them anyway, e.g. to check the path without a GPU
+			const char* renderer = (const char*)glGetString(GL_RENDERER);
+			for (const char* software : { "llvmpipe", "softpipe", "swrast", "GDI Generic" })
+				if (renderer != nullptr && std::strstr(renderer, software) != nullptr)
+					return;
+#endif
+
+			glGenBuffers = (glGenBuffers_t*)GetProc("glGenBuffers");
+			glDeleteBuffers = (glDeleteBuffers_t*)GetProc("glDeleteBuffers");
+			glBindBuffer = (glBindBuffer_t*)GetProc("glBindBuffer");
+			glBufferData = (glBufferData_t*)GetProc("glBufferData");
+			glMapBuffer = (glMapBuffer_t*)GetProc("glMapBuffer");
+			glUnmapBuffer = (glUnmapBuffer_t*)GetProc("glUnmapBuffer");
+			bPixelBuffers = glGenBuffers && glDeleteBuffers && glBindBuffer && glBufferData && glMapBuffer && glUnmapBuffer;
+#endif
+		}
+
 		olc::rcode DestroyDevice() override
 		{
 #if defined(_WIN32)
@@ -2958,14 +3100,70 @@ namespace olc
 
 		uint32_t DeleteTexture(const uint32_t id) override
 		{
+			auto buffer = mapPixelBuffers.find(id);
+			if (buffer != mapPixelBuffers.end())
+			{
+				glDeleteBuffers(1, &buffer->second);
+				mapPixelBuffers.erase(buffer);
+			}
+			mapTextureSize.erase(id);
 			glDeleteTextures(1, &id);
 			return id;
 		}
 
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
-			UNUSED(id);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			// The texture is allocated with the first upload and again only if the sprite changes size,
+			// every other upload only sends the regions the sprite marked dirty since the last one
+			olc::vi2d& size = mapTextureSize[id];
+			if (size.x != spr->width || size.y != spr->height)
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+				size = { spr->width, spr->height };
+			}
+			else if (!spr->GetDirtyRects().empty())
+			{
+				if (!bPixelBuffers || !StreamDirtyRects(id, spr))
+					UploadDirtyRects(spr, (uintptr_t)spr->GetData());
+			}
+			spr->ClearDirty();
+		}
+
+		// Copies the dirty regions into fresh storage of the texture's pixel buffer and uploads them from there
+		bool StreamDirtyRects(uint32_t id, olc::Sprite* spr)
+		{
+			GLuint& buffer = mapPixelBuffers[id];
+			if (buffer == 0) glGenBuffers(1, &buffer);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+			// Orphan the old storage: a transfer still reading it keeps it, so mapping never waits for one
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, (ptrdiff_t)spr->width * spr->height * sizeof(olc::Pixel), nullptr, GL_STREAM_DRAW);
+
+			olc::Pixel* mapped = (olc::Pixel*)glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+			if (mapped == nullptr)
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				return false;
+			}
+			for (const auto& rect : spr->GetDirtyRects())
+				for (int32_t y = rect.pos.y; y < rect.pos.y + rect.size.y; y++)
+				{
+					size_t offset = (size_t)y * spr->width + rect.pos.x;
+					std::memcpy(mapped + offset, spr->GetData() + offset, rect.size.x * sizeof(olc::Pixel));
+				}
+			bool bMapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+			if (bMapped) UploadDirtyRects(spr, 0);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			return bMapped;
+		}
+
+		// Sends the dirty regions from data laid out like the sprite: its own pixels, or offset 0 of the bound pixel buffer
+		void UploadDirtyRects(olc::Sprite* spr, uintptr_t data)
+		{
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, spr->width);
+			for (const auto& rect : spr->GetDirtyRects())
+				glTexSubImage2D(GL_TEXTURE_2D, 0, rect.pos.x, rect.pos.y, rect.size.x, rect.size.y, GL_RGBA, GL_UNSIGNED_BYTE,
+					(const GLvoid*)(data + ((size_t)rect.pos.y * spr->width + rect.pos.x) * sizeof(olc::Pixel)));
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 		}
 
 		void ApplyTexture(uint32_t id) override
@@ -3996,9 +4194,160 @@ namespace olc {
 // O------------------------------------------------------------------------------O
 
 
+// O------------------------------------------------------------------------------O
+// | START PLATFORM & RENDERER: HEADLESS                                          |
+// O------------------------------------------------------------------------------O
+// Chosen at run time by Construct(..., headless = true). No window, no graphics
+// context, no input: the layers stay in their sprites and presenting does nothing,
+// so the engine thread runs OnUserUpdate as fast as it can.
+namespace olc
+{
+	class Renderer_Headless : public olc::Renderer
+	{
+	public:
+		void PrepareDevice() override
+		{
+		}
+
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override
+		{
+			UNUSED(params);
+			UNUSED(bFullScreen);
+			UNUSED(bVSYNC);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode DestroyDevice() override
+		{
+			return olc::rcode::OK;
+		}
+
+		void DisplayFrame() override
+		{
+		}
+
+		void PrepareDrawing() override
+		{
+		}
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			UNUSED(offset);
+			UNUSED(scale);
+			UNUSED(tint);
+		}
+
+		void DrawDecalQuad(const olc::DecalInstance& decal) override
+		{
+			UNUSED(decal);
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height) override
+		{
+			UNUSED(width);
+			UNUSED(height);
+			return 0;
+		}
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			UNUSED(id);
+			spr->ClearDirty();
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			return id;
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{
+			UNUSED(id);
+		}
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			UNUSED(pos);
+			UNUSED(size);
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			UNUSED(p);
+			UNUSED(bDepth);
+		}
+	};
+
+	class Platform_Headless : public olc::Platform
+	{
+	public:
+		olc::rcode ApplicationStartUp() override
+		{
+			return olc::rcode::OK;
+		}
+
+		olc::rcode ApplicationCleanUp() override
+		{
+			return olc::rcode::OK;
+		}
+
+		olc::rcode ThreadStartUp() override
+		{
+			return olc::rcode::OK;
+		}
+
+		olc::rcode ThreadCleanUp() override
+		{
+			return renderer->DestroyDevice();
+		}
+
+		olc::rcode CreateGraphics(bool bFullScreen, bool bEnableVSYNC, const olc::vi2d& vViewPos, const olc::vi2d& vViewSize) override
+		{
+			UNUSED(vViewPos);
+			UNUSED(vViewSize);
+			return renderer->CreateDevice({}, bFullScreen, bEnableVSYNC);
+		}
+
+		olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override
+		{
+			UNUSED(vWindowPos);
+			UNUSED(vWindowSize);
+			UNUSED(bFullScreen);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode SetWindowTitle(const std::string& s) override
+		{
+			UNUSED(s);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode StartSystemEventLoop() override
+		{
+			return olc::rcode::OK;
+		}
+
+		olc::rcode HandleSystemEvent() override
+		{
+			return olc::rcode::OK;
+		}
+	};
+}
+// O------------------------------------------------------------------------------O
+// | END PLATFORM & RENDERER: HEADLESS                                            |
+// O------------------------------------------------------------------------------O
+
 
 namespace olc
 {
+	void PixelGameEngine::olc_ConfigureHeadless()
+	{
+		platform = std::make_unique<olc::Platform_Headless>();
+		renderer = std::make_unique<olc::Renderer_Headless>();
+		platform->ptrPGE = this;
+		renderer->ptrPGE = this;
+	}
+
 	void PixelGameEngine::olc_ConfigureSystem()
 	{
 